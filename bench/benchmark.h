@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// micro benchmark harness shared by the snippet folders
+// every case runs on every corpus input: warmup, calibrated batch size, repeated samples
+// reports median, p99, ns per input byte and heap allocations per call, output as table, CSV or JSON
+// allocations are counted only when BENCH_COUNT_ALLOCATIONS is defined before including (replaces global operator new)
+namespace bench {
+  // number of operator new calls since program start
+  inline std::atomic<size_t>& allocation_counter() {
+    static std::atomic<size_t> count{ 0 };
+    return count;
+  }
+
+  // keeps value alive so compiler can't drop the computation producing it
+  template <class T>
+  inline void do_not_optimize(T const& value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+  }
+
+  // one benchmark input
+  struct input {
+    std::string name;
+    std::string data;
+  };
+
+  struct result {
+    std::string name;
+    std::string input;
+    size_t bytes;
+    size_t samples;
+    size_t iterations;  // calls per sample
+    double median_ns;   // per call
+    double p99_ns;      // per call
+    double ns_per_byte; // median based
+    double allocations; // per call, 0 unless BENCH_COUNT_ALLOCATIONS
+  };
+
+  class runner {
+  public:
+    // corpus may be empty when every case is run on its own inputs
+    explicit runner(std::vector<input> corpus = {}, size_t samples = 101,
+                    std::chrono::nanoseconds min_sample_time = std::chrono::microseconds(50))
+      : corpus_(std::move(corpus)), samples_(samples), min_sample_time_(min_sample_time) {
+    }
+
+    // fn(const std::string& input) is one measured call
+    template <class F>
+    void run(const std::string& name, F&& fn) {
+      run(name, corpus_, fn);
+    }
+
+    // same, on inputs other than runner's corpus
+    template <class F>
+    void run(const std::string& name, const std::vector<input>& corpus, F&& fn) {
+      for (const auto& in : corpus) {
+        const size_t iterations = calibrate(fn, in.data);
+
+        // warmup: caches, branch predictors, lazy allocations
+        for (int i = 0; i < 3; ++i) measure(fn, in.data, iterations);
+
+        std::vector<double> per_call(samples_);
+        const size_t allocations = allocation_counter().load(std::memory_order_relaxed);
+        for (auto& sample : per_call) {
+          sample = static_cast<double>(measure(fn, in.data, iterations).count()) / iterations;
+        }
+        const size_t allocated = allocation_counter().load(std::memory_order_relaxed) - allocations;
+        std::sort(per_call.begin(), per_call.end());
+
+        result r;
+        r.name = name;
+        r.input = in.name;
+        r.bytes = in.data.size();
+        r.samples = samples_;
+        r.iterations = iterations;
+        r.median_ns = per_call[per_call.size() / 2];
+        r.p99_ns = per_call[std::min(per_call.size() - 1, (per_call.size() * 99 + 99) / 100 - 1)];
+        r.ns_per_byte = r.bytes ? r.median_ns / r.bytes : 0.0;
+        r.allocations = static_cast<double>(allocated) / (samples_ * iterations);
+        results_.push_back(r);
+      }
+    }
+
+    const std::vector<result>& results() const { return results_; }
+
+    void print_table(std::ostream& os) const {
+      os << std::left << std::setw(40) << "name" << std::setw(22) << "input"
+         << std::right << std::setw(12) << "median ns" << std::setw(12) << "p99 ns" << std::setw(10) << "ns/byte" << std::setw(10) << "allocs" << "\n";
+      os << std::fixed << std::setprecision(2);
+      for (const auto& r : results_) {
+        os << std::left << std::setw(40) << r.name << std::setw(22) << r.input
+           << std::right << std::setw(12) << r.median_ns << std::setw(12) << r.p99_ns << std::setw(10) << r.ns_per_byte << std::setw(10) << r.allocations << "\n";
+      }
+    }
+
+    void print_csv(std::ostream& os) const {
+      os << "name,input,bytes,samples,iterations,median_ns,p99_ns,ns_per_byte,allocations\n";
+      os << std::fixed << std::setprecision(3);
+      for (const auto& r : results_) {
+        os << quoted(r.name, '"') << "," << quoted(r.input, '"') << "," << r.bytes << "," << r.samples << "," << r.iterations
+           << "," << r.median_ns << "," << r.p99_ns << "," << r.ns_per_byte << "," << r.allocations << "\n";
+      }
+    }
+
+    void print_json(std::ostream& os) const {
+      os << "[\n" << std::fixed << std::setprecision(3);
+      for (size_t i = 0; i < results_.size(); ++i) {
+        const auto& r = results_[i];
+        os << "  {\"name\": " << quoted(r.name, '\\') << ", \"input\": " << quoted(r.input, '\\') << ", \"bytes\": " << r.bytes
+           << ", \"samples\": " << r.samples << ", \"iterations\": " << r.iterations << ", \"median_ns\": " << r.median_ns
+           << ", \"p99_ns\": " << r.p99_ns << ", \"ns_per_byte\": " << r.ns_per_byte
+           << ", \"allocations\": " << r.allocations << "}"
+           << (i + 1 < results_.size() ? ",\n" : "\n");
+      }
+      os << "]\n";
+    }
+
+  private:
+    template <class F>
+    static std::chrono::nanoseconds measure(F& fn, const std::string& data, size_t iterations) {
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < iterations; ++i) {
+        fn(data);
+      }
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    // smallest power of two batch lasting at least min_sample_time_, keeps timer resolution out of results
+    template <class F>
+    size_t calibrate(F& fn, const std::string& data) const {
+      size_t iterations = 1;
+      while (measure(fn, data, iterations) < min_sample_time_ && iterations < (size_t(1) << 30)) {
+        iterations *= 2;
+      }
+      return iterations;
+    }
+
+    // CSV doubles the quote, JSON escapes it with backslash
+    static std::string quoted(const std::string& s, char escape) {
+      std::string out("\"");
+      for (char c : s) {
+        if (c == '"' || (escape == '\\' && c == '\\')) out.push_back(escape);
+        out.push_back(c);
+      }
+      out.push_back('"');
+      return out;
+    }
+
+    std::vector<input> corpus_;
+    size_t samples_;
+    std::chrono::nanoseconds min_sample_time_;
+    std::vector<result> results_;
+  };
+}  // namespace bench
+
+#if defined(BENCH_COUNT_ALLOCATIONS)
+// out of line like the library versions: a release inlined down to free but paired with an operator new call
+// is reported by GCC -Wmismatched-new-delete, noipa also keeps the identical new and new[] from being merged
+#if defined(_MSC_VER) && !defined(__clang__)
+#define BENCH_ALLOCATION_FUNCTION __declspec(noinline)
+#elif defined(__clang__)
+#define BENCH_ALLOCATION_FUNCTION __attribute__((noinline))
+#else
+#define BENCH_ALLOCATION_FUNCTION __attribute__((noipa))
+#endif
+
+BENCH_ALLOCATION_FUNCTION void* operator new(std::size_t size) {
+  bench::allocation_counter().fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+// counts and allocates on its own, so every allocation and release pair is malloc/free
+BENCH_ALLOCATION_FUNCTION void* operator new[](std::size_t size) {
+  bench::allocation_counter().fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+BENCH_ALLOCATION_FUNCTION void operator delete(void* p) noexcept { std::free(p); }
+BENCH_ALLOCATION_FUNCTION void operator delete[](void* p) noexcept { std::free(p); }
+BENCH_ALLOCATION_FUNCTION void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+BENCH_ALLOCATION_FUNCTION void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+#endif
@@ -0,0 +1,135 @@
+// g++ -std=c++17 -O2 benchmark.cpp duration_to_string.cpp
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "duration_to_string.h"
+#include "timestamp.h"
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "../bench/benchmark.h"
+
+// per call version from findings.cpp, kept for comparison
+namespace findings {
+  using time_point = std::chrono::system_clock::time_point;
+
+  std::string time_point_to_string(const time_point &time)
+  {
+  	uint64_t nsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+  	unsigned int secs = nsecs / 1000000000ULL;
+
+  	std::ostringstream ossTimestamp;
+  	ossTimestamp.fill('0');
+  	ossTimestamp << secs / (60 * 60) << ":"
+  		     << std::setw(2) << (secs / 60) % 60 << ":"
+  		     << std::setw(2) << secs % 60 << "."
+  		     << std::setw(9) << nsecs % 1000000000ULL;
+  	return ossTimestamp.str();
+  }
+}  // namespace findings
+
+int main(int argc, char* argv[])
+{
+  // --csv or --json for machine readable output to track regressions between commits
+  const std::string output(argc > 1 ? argv[1] : "");
+
+  bench::runner r;
+
+  // microseconds only, seconds, every unit
+  for (int64_t elapsed : { int64_t(567), int64_t(12345678), int64_t(98765432101234) }) {
+    const std::vector<bench::input> corpus = { { "us=" + std::to_string(elapsed), "" } };
+
+    r.run("as_string - ostringstream", corpus, [elapsed](const std::string&) {
+      bench::do_not_optimize(Elapsed::get_elapsed_time_as_string(elapsed));
+    });
+
+    r.run("get_elapsed_time - fixed", corpus, [elapsed](const std::string&) {
+      bench::do_not_optimize(Elapsed::get_elapsed_time(elapsed));
+    });
+
+    r.run("write_elapsed_time - buffer", corpus, [elapsed](const std::string&) {
+      char buffer[Elapsed::MAX_STRING_SIZE];
+      bench::do_not_optimize(Elapsed::write_elapsed_time(elapsed, buffer));
+      bench::do_not_optimize(buffer);
+    });
+  }
+
+  // log flush: consecutive timestamps a few microseconds apart
+  {
+    constexpr size_t kCount = 10000;
+    std::vector<findings::time_point> times;
+    std::vector<uint64_t> ns;
+    const auto start = std::chrono::system_clock::now();
+    for (size_t i = 0; i < kCount; ++i) {
+      times.push_back(start + std::chrono::nanoseconds(i * 3517));
+      ns.push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(times.back().time_since_epoch()).count()));
+    }
+    const std::vector<bench::input> corpus = { { "timestamps=" + std::to_string(kCount), std::string(kCount * (timestamp::TIME_SIZE + 1), ' ') } };
+
+    r.run("time_point_to_string per call", corpus, [&](const std::string&) {
+      std::string out;
+      for (const auto& t : times) {
+        out += findings::time_point_to_string(t);
+        out += '\n';
+      }
+      bench::do_not_optimize(out);
+    });
+
+    std::string out;
+    r.run("timestamp::format_times - time_point", corpus, [&](const std::string&) {
+      out.clear();
+      timestamp::format_times(times, out);
+      bench::do_not_optimize(out);
+    });
+
+    r.run("timestamp::format_times - ns", corpus, [&](const std::string&) {
+      out.clear();
+      timestamp::format_times(ns, out);
+      bench::do_not_optimize(out);
+    });
+
+    // logger timestamp stage "YYYY-MM-DD hh:mm:ss.ffffff" for every record
+    r.run("date time - gmtime + strftime", corpus, [&](const std::string&) {
+      char line[64];
+      for (const auto& t : times) {
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count();
+        const std::time_t seconds = static_cast<std::time_t>(us / 1000000);
+        const size_t size = std::strftime(line, sizeof(line), "%Y-%m-%d %H:%M:%S", std::gmtime(&seconds));
+        std::snprintf(line + size, sizeof(line) - size, ".%06d", static_cast<int>(us % 1000000));
+        bench::do_not_optimize(line);
+      }
+    });
+
+    r.run("date time - civil date every call", corpus, [&](const std::string&) {
+      char line[64];
+      for (uint64_t t : ns) {
+        char* end = timestamp::write_date_time(line, static_cast<int64_t>(t / 1000000000));
+        *end++ = '.';
+        digits::write_fixed(end, t % 1000000000 / 1000, 6);
+        bench::do_not_optimize(line);
+      }
+    });
+
+    r.run("date time - cached per thread", corpus, [&](const std::string&) {
+      char line[64];
+      for (const auto& t : times) {
+        timestamp::write_log_time(line, t);
+        bench::do_not_optimize(line);
+      }
+    });
+  }
+
+  if (output == "--csv") {
+    r.print_csv(std::cout);
+  } else if (output == "--json") {
+    r.print_json(std::cout);
+  } else {
+    r.print_table(std::cout);
+  }
+}
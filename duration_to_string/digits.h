@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// integer to decimal text for fixed layouts, two digits per division from lookup table
+// no locale, no allocation, caller owns the buffer
+namespace digits {
+  namespace detail {
+    struct pair_table {
+      char data[200];
+      constexpr pair_table() : data() {
+        for (int i = 0; i < 100; ++i) {
+          data[2 * i] = static_cast<char>('0' + i / 10);
+          data[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+      }
+    };
+    inline constexpr pair_table pairs{};
+  }  // namespace detail
+
+  // value < 100, always two digits
+  inline char* write2(char* out, std::uint32_t value) {
+    std::memcpy(out, detail::pairs.data + 2 * value, 2);
+    return out + 2;
+  }
+
+  // value < 1000, always three digits
+  inline char* write3(char* out, std::uint32_t value) {
+    *out = static_cast<char>('0' + value / 100);
+    return write2(out + 1, value % 100);
+  }
+
+  // value < 10^8, always eight digits
+  // digits are computed together in one 64-bit register (SWAR): no table, no branches,
+  // fixed instruction sequence that vectorizes in batch loops
+  inline char* write8(char* out, std::uint32_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (int i = 7; i >= 0; --i, value /= 10) out[i] = static_cast<char>('0' + value % 10);
+#else
+    // two 4-digit lanes of 32 bits, first digits in low lane (lower address on little endian)
+    std::uint64_t x = (value / 10000) | (static_cast<std::uint64_t>(value % 10000) << 32);
+    // each lane / 100, (x * 10486) >> 20 is exact below 10000
+    const std::uint64_t hundreds = ((x * 10486) >> 20) & 0x0000007F0000007FULL;
+    x = hundreds | ((x - hundreds * 100) << 16);
+    // four 16-bit lanes / 10, (x * 103) >> 10 is exact below 100
+    const std::uint64_t tens = ((x * 103) >> 10) & 0x000F000F000F000FULL;
+    x = tens | ((x - tens * 10) << 8);
+    x |= 0x3030303030303030ULL;
+    std::memcpy(out, &x, 8);
+#endif
+    return out + 8;
+  }
+
+  // value < 10^width, zero padded to width
+  inline char* write_fixed(char* out, std::uint64_t value, int width) {
+    char* end = out + width;
+    char* p = end;
+    for (; width >= 2; width -= 2) {
+      p -= 2;
+      std::memcpy(p, detail::pairs.data + 2 * (value % 100), 2);
+      value /= 100;
+    }
+    if (width) *--p = static_cast<char>('0' + value % 10);
+    return end;
+  }
+
+  // no padding, up to 20 digits
+  inline char* write(char* out, std::uint64_t value) {
+    char buffer[20];
+    char* end = buffer + sizeof(buffer);
+    char* p = end;
+    while (value >= 100) {
+      p -= 2;
+      std::memcpy(p, detail::pairs.data + 2 * (value % 100), 2);
+      value /= 100;
+    }
+    if (value >= 10) {
+      p -= 2;
+      std::memcpy(p, detail::pairs.data + 2 * value, 2);
+    } else {
+      *--p = static_cast<char>('0' + value);
+    }
+    std::memcpy(out, p, end - p);
+    return out + (end - p);
+  }
+}  // namespace digits
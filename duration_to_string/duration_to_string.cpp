@@ -1,3 +1,10 @@
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+#include "digits.h"
+#include "duration_to_string.h"
+
 std::string Elapsed::get_elapsed_time_as_string(int64_t elapsed_in_microseconds) {
   std::chrono::microseconds elapsed_us(elapsed_in_microseconds);
   std::ostringstream os;
@@ -54,3 +61,55 @@ std::string Elapsed::get_elapsed_time_as_string(int64_t elapsed_in_microseconds)
 
   return os.str();
 }
+
+std::size_t Elapsed::write_elapsed_time(int64_t elapsed_in_microseconds, char* buffer) {
+  char* out = buffer;
+  // negative value: sign and magnitude
+  uint64_t us = static_cast<uint64_t>(elapsed_in_microseconds);
+  if (elapsed_in_microseconds < 0) {
+    *out++ = '-';
+    us = 0 - us;
+  }
+
+  constexpr uint64_t US_PER_SECOND = 1000000;
+  constexpr uint64_t SECONDS_PER_DAY = 86400;
+  constexpr uint64_t SECONDS_PER_YEAR = SECONDS_PER_DAY * 365;
+
+  const uint64_t total_seconds = us / US_PER_SECOND;
+  const auto sub_second = static_cast<uint32_t>(us % US_PER_SECOND);
+  const uint64_t years = total_seconds / SECONDS_PER_YEAR;
+  const auto second_of_year = static_cast<uint32_t>(total_seconds % SECONDS_PER_YEAR);
+  const uint32_t days = second_of_year / SECONDS_PER_DAY;
+  const uint32_t second_of_day = second_of_year % SECONDS_PER_DAY;
+
+  const uint64_t units[] = { years, days, second_of_day / 3600, second_of_day / 60 % 60, second_of_day % 60 };
+  const char* const suffixes[] = { "y:", "d:", "h:", "m:", "s:" };
+
+  bool found_non_zero = false;
+  for (int i = 0; i < 5; ++i) {
+    if (units[i] || found_non_zero) {
+      found_non_zero = true;
+      out = digits::write(out, units[i]);
+      std::memcpy(out, suffixes[i], 2);
+      out += 2;
+    }
+  }
+
+  const uint32_t ms = sub_second / 1000;
+  if (ms || found_non_zero) {
+    out = digits::write3(out, ms);
+    std::memcpy(out, "ms:", 3);
+    out += 3;
+  }
+  out = digits::write3(out, sub_second % 1000);
+  std::memcpy(out, "us", 2);
+  out += 2;
+
+  return static_cast<std::size_t>(out - buffer);
+}
+
+Elapsed::elapsed_string Elapsed::get_elapsed_time(int64_t elapsed_in_microseconds) {
+  elapsed_string result;
+  result.size = static_cast<std::uint8_t>(write_elapsed_time(elapsed_in_microseconds, result.data));
+  return result;
+}
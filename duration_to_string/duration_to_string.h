@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class Elapsed {
+public:
+  // longest text: "-292471y:364d:23h:59m:59s:999ms:999us"
+  static constexpr std::size_t MAX_STRING_SIZE = 40;
+
+  // fixed size text, no allocation
+  struct elapsed_string {
+    char data[MAX_STRING_SIZE];
+    std::uint8_t size;
+
+    std::string_view view() const { return std::string_view(data, size); }
+  };
+
+  // "1h:2m:3s:004ms:005us", leading zero units are skipped
+  static std::string get_elapsed_time_as_string(int64_t elapsed_in_microseconds);
+
+  // same text, integer divide/mod on microsecond count and two-digit table, no stream
+  // buffer needs MAX_STRING_SIZE bytes, returns written size
+  static std::size_t write_elapsed_time(int64_t elapsed_in_microseconds, char* buffer);
+  static elapsed_string get_elapsed_time(int64_t elapsed_in_microseconds);
+};
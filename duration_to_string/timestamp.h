@@ -0,0 +1,179 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "digits.h"
+
+// fixed width timestamps for log output
+// "hh:mm:ss.nnnnnnnnn" many at once into one buffer, "YYYY-MM-DD hh:mm:ss.ffffff" with cached date part
+// hh is hour of day (UTC for system_clock), unlike time_point_to_string in findings.cpp which prints hours since epoch
+// every record has the same layout, so the batch loop is straight-line code: constant divisions and
+// SWAR digit conversion, no streams, no branches on digit count
+namespace timestamp {
+  constexpr std::int64_t NS_PER_SECOND = 1000000000;
+  constexpr std::size_t TIME_SIZE = 18;  // "hh:mm:ss.nnnnnnnnn"
+
+  // one record, out needs TIME_SIZE bytes, returns end of record
+  inline char* write_time(char* out, std::uint64_t ns_since_epoch) {
+    const std::uint64_t seconds = ns_since_epoch / NS_PER_SECOND;
+    const auto ns = static_cast<std::uint32_t>(ns_since_epoch % NS_PER_SECOND);
+    const auto second_of_day = static_cast<std::uint32_t>(seconds % 86400);
+
+    out = digits::write2(out, second_of_day / 3600);
+    *out++ = ':';
+    out = digits::write2(out, second_of_day / 60 % 60);
+    *out++ = ':';
+    out = digits::write2(out, second_of_day % 60);
+    *out++ = '.';
+    *out++ = static_cast<char>('0' + ns / 100000000);
+    return digits::write8(out, ns % 100000000);
+  }
+
+  // count records, each followed by separator, from nanoseconds since epoch (not before epoch)
+  // out needs count * (TIME_SIZE + 1) bytes, returns written bytes
+  inline std::size_t format_times(const std::uint64_t* ns, std::size_t count, char* out, char separator = '\n') {
+    for (std::size_t i = 0; i < count; ++i) {
+      char* record = out + i * (TIME_SIZE + 1);
+      write_time(record, ns[i]);
+      record[TIME_SIZE] = separator;
+    }
+    return count * (TIME_SIZE + 1);
+  }
+
+  template <class Clock, class Duration>
+  std::size_t format_times(const std::chrono::time_point<Clock, Duration>* times, std::size_t count, char* out, char separator = '\n') {
+    for (std::size_t i = 0; i < count; ++i) {
+      char* record = out + i * (TIME_SIZE + 1);
+      const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(times[i].time_since_epoch()).count();
+      write_time(record, static_cast<std::uint64_t>(ns));
+      record[TIME_SIZE] = separator;
+    }
+    return count * (TIME_SIZE + 1);
+  }
+
+  // appends records to out, one resize for the whole batch
+  inline void format_times(const std::vector<std::uint64_t>& ns, std::string& out, char separator = '\n') {
+    const std::size_t offset = out.size();
+    out.resize(offset + ns.size() * (TIME_SIZE + 1));
+    format_times(ns.data(), ns.size(), &out[offset], separator);
+  }
+
+  template <class Clock, class Duration>
+  void format_times(const std::vector<std::chrono::time_point<Clock, Duration>>& times, std::string& out, char separator = '\n') {
+    const std::size_t offset = out.size();
+    out.resize(offset + times.size() * (TIME_SIZE + 1));
+    format_times(times.data(), times.size(), &out[offset], separator);
+  }
+
+  constexpr std::size_t DATE_TIME_SIZE = 19;  // "YYYY-MM-DD hh:mm:ss"
+
+  // days since 1970-01-01 to year, month, day (Howard Hinnant's civil_from_days)
+  struct civil_date {
+    std::int64_t year;
+    unsigned month;
+    unsigned day;
+  };
+
+  inline civil_date civil_from_days(std::int64_t z) {
+    z += 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    const unsigned d = doy - (153 * mp + 2) / 5 + 1;
+    const unsigned m = mp < 10 ? mp + 3 : mp - 9;
+    return { static_cast<std::int64_t>(yoe) + era * 400 + (m <= 2), m, d };
+  }
+
+  // "YYYY-MM-DD hh:mm:ss" for seconds since epoch, years 0000-9999, out needs DATE_TIME_SIZE bytes
+  inline char* write_date_time(char* out, std::int64_t seconds_since_epoch) {
+    std::int64_t days = seconds_since_epoch / 86400;
+    std::int64_t second_of_day = seconds_since_epoch % 86400;
+    if (second_of_day < 0) {
+      second_of_day += 86400;
+      --days;
+    }
+    const civil_date date = civil_from_days(days);
+    const auto sod = static_cast<std::uint32_t>(second_of_day);
+
+    out = digits::write_fixed(out, static_cast<std::uint64_t>(date.year), 4);
+    *out++ = '-';
+    out = digits::write2(out, date.month);
+    *out++ = '-';
+    out = digits::write2(out, date.day);
+    *out++ = ' ';
+    out = digits::write2(out, sod / 3600);
+    *out++ = ':';
+    out = digits::write2(out, sod / 60 % 60);
+    *out++ = ':';
+    return digits::write2(out, sod % 60);
+  }
+
+  // "YYYY-MM-DD hh:mm:ss" with FractionDigits (0, 3, 6 or 9) digits after point
+  // date and time of day are formatted only when the second changes and copied otherwise,
+  // consecutive log records mostly fall in the same second
+  // one instance per thread, see write_log_time
+  template <int FractionDigits = 6>
+  class date_time_formatter {
+    static_assert(FractionDigits == 0 || FractionDigits == 3 || FractionDigits == 6 || FractionDigits == 9,
+                  "fraction digits are 0, 3, 6 or 9");
+
+  public:
+    static constexpr std::size_t SIZE = DATE_TIME_SIZE + (FractionDigits ? FractionDigits + 1 : 0);
+
+    // out needs SIZE bytes, returns end of text
+    char* write(char* out, std::int64_t ns_since_epoch) {
+      std::int64_t seconds = ns_since_epoch / NS_PER_SECOND;
+      std::int64_t ns = ns_since_epoch % NS_PER_SECOND;
+      if (ns < 0) {
+        ns += NS_PER_SECOND;
+        --seconds;
+      }
+      if (seconds != cached_second_) {
+        write_date_time(prefix_, seconds);
+        cached_second_ = seconds;
+      }
+      std::memcpy(out, prefix_, DATE_TIME_SIZE);
+      out += DATE_TIME_SIZE;
+
+      const auto fraction = static_cast<std::uint32_t>(ns);
+      if constexpr (FractionDigits == 3) {
+        *out++ = '.';
+        out = digits::write3(out, fraction / 1000000);
+      } else if constexpr (FractionDigits == 6) {
+        *out++ = '.';
+        out = digits::write_fixed(out, fraction / 1000, 6);
+      } else if constexpr (FractionDigits == 9) {
+        *out++ = '.';
+        *out++ = static_cast<char>('0' + fraction / 100000000);
+        out = digits::write8(out, fraction % 100000000);
+      }
+      return out;
+    }
+
+    template <class Clock, class Duration>
+    char* write(char* out, std::chrono::time_point<Clock, Duration> time) {
+      return write(out, static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count()));
+    }
+
+  private:
+    std::int64_t cached_second_ = INT64_MIN;
+    char prefix_[DATE_TIME_SIZE];
+  };
+
+  // logger timestamp stage: system_clock time as "YYYY-MM-DD hh:mm:ss.ffffff" (UTC) with per thread cache
+  //   char line[256];
+  //   char* out = timestamp::write_log_time(line, std::chrono::system_clock::now());
+  // out needs date_time_formatter<FractionDigits>::SIZE bytes
+  template <int FractionDigits = 6, class Clock, class Duration>
+  char* write_log_time(char* out, std::chrono::time_point<Clock, Duration> time) {
+    thread_local date_time_formatter<FractionDigits> formatter;
+    return formatter.write(out, time);
+  }
+}  // namespace timestamp
@@ -0,0 +1,205 @@
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "code.h"
+#include "chunked_builder.h"
+#include "fixed_string_builder.h"
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "../bench/benchmark.h"
+
+// previous concat implementation, kept for comparison
+namespace stream {
+  template<class... Args>
+  [[nodiscard]] std::string concat(const Args&... args)
+  {
+    if constexpr (sizeof...(args) == 0) {
+      return {};
+    } else {
+      std::ostringstream os;
+      ((os << args),...);
+      return os.str();
+    }
+  }
+}
+
+// previous join implementations, kept for comparison
+// concatenates with separator
+namespace accumulate {
+inline std::string join(const std::vector<std::string>& a_vec, const char* separator) {
+  return std::accumulate(a_vec.begin(), a_vec.end(), std::string{},
+    [separator](const auto& str1, const auto& str2) {
+      return str1.empty() ? str2 : str1 + separator + str2;
+    });
+}
+}  // namespace accumulate
+
+// avoid re-allocations
+namespace reserve {
+inline std::string join(const std::vector<std::string>& svec, const std::string& sepa) {
+	if (svec.empty())	return {};
+	/* calculate the overall size beforehand, to avoid re-allocations. */
+	size_t value_len =
+		std::accumulate(svec.cbegin(), svec.cend(), 0,
+				[](size_t size, const std::string& s) {
+					return size + s.size();
+				}) + (svec.size() - 1) * sepa.length();
+
+	std::string value;
+	value.reserve(value_len);
+
+	std::accumulate(svec.cbegin(), svec.cend(), std::ref(value),
+			[&](std::string& s1, const std::string& s2)->std::string& {
+				if (s1.empty())
+					s1 = s2;
+				else {
+					s1.append(sepa);
+					s1.append(s2);
+				}
+				return s1;
+			});
+
+	return value;
+}
+}  // namespace reserve
+
+// std::next trick
+namespace next_trick {
+inline std::string join(const std::vector<std::string>& input, const char* separator) {
+    return input.empty() ? std::string() :
+      std::accumulate(std::next(input.begin()), input.end(), input.front(),
+      [separator](const auto& a, const auto& b) -> std::string { return a + separator + b; });
+}
+}  // namespace next_trick
+
+int main(int argc, char* argv[])
+{
+  // --csv or --json for machine readable output to track regressions between commits
+  const std::string output(argc > 1 ? argv[1] : "");
+
+  // input string is used as one of the concatenated arguments
+  bench::runner r({ { "short", "battery" }, { "long", std::string(200, 'x') } });
+
+  r.run("stream::concat - strings", [](const std::string& test) {
+    auto s = stream::concat("element: ", test, std::string_view(", state: "), std::string("ok"));
+    bench::do_not_optimize(s);
+  });
+
+  r.run("concat - strings", [](const std::string& test) {
+    auto s = concat("element: ", test, std::string_view(", state: "), std::string("ok"));
+    bench::do_not_optimize(s);
+  });
+
+  r.run("stream::concat - mixed", [](const std::string& test) {
+    auto s = stream::concat("id=", 42, " element=", test, " value=", 3.25, " count=", 123456789ull, ' ', -7);
+    bench::do_not_optimize(s);
+  });
+
+  r.run("concat - mixed", [](const std::string& test) {
+    auto s = concat("id=", 42, " element=", test, " value=", 3.25, " count=", 123456789ull, ' ', -7);
+    bench::do_not_optimize(s);
+  });
+
+  // short log line built in place, heap used only by spill policy when the long input doesn't fit
+  r.run("fixed<128> - mixed", [](const std::string& test) {
+    fixed_string_builder<128> s;
+    s.append("id=", 42, " element=", test, " value=", 3.25, " count=", 123456789ull, ' ', -7);
+    bench::do_not_optimize(s);
+  });
+
+  r.run("fixed<128, spill> - mixed", [](const std::string& test) {
+    fixed_string_builder<128, overflow_policy::spill> s;
+    s.append("id=", 42, " element=", test, " value=", 3.25, " count=", 123456789ull, ' ', -7);
+    bench::do_not_optimize(s);
+  });
+
+  // join over vectors of different length, input string is unused
+  for (size_t count : { size_t(16), size_t(10000), size_t(1000000) }) {
+    std::vector<std::string> strings;
+    std::vector<std::string_view> views;
+    strings.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      strings.push_back("element" + std::to_string(i));
+    }
+    views.assign(strings.begin(), strings.end());
+    const std::vector<bench::input> corpus = { { "elements=" + std::to_string(count), "" } };
+
+    // quadratic variants only on small inputs
+    if (count <= 10000) {
+      r.run("accumulate::join", corpus, [&](const std::string&) {
+        auto s = accumulate::join(strings, ", ");
+        bench::do_not_optimize(s);
+      });
+
+      r.run("next_trick::join", corpus, [&](const std::string&) {
+        auto s = next_trick::join(strings, ", ");
+        bench::do_not_optimize(s);
+      });
+    }
+
+    r.run("reserve::join", corpus, [&](const std::string&) {
+      auto s = reserve::join(strings, ", ");
+      bench::do_not_optimize(s);
+    });
+
+    r.run("join - std::string", corpus, [&](const std::string&) {
+      auto s = join(strings, ", ");
+      bench::do_not_optimize(s);
+    });
+
+    r.run("join - std::string_view", corpus, [&](const std::string&) {
+      auto s = join(views, ", ");
+      bench::do_not_optimize(s);
+    });
+
+    r.run("join - parallel", corpus, [&](const std::string&) {
+      auto s = join(views, ", ", join_policy::parallel);
+      bench::do_not_optimize(s);
+    });
+  }
+
+#if !defined(_WIN32)
+  // multi-megabyte response written to /dev/null: growing std::string against chunked blocks + writev
+  // skipped when /dev/null can't be opened
+  if (const int fd = ::open("/dev/null", O_WRONLY); fd >= 0) {
+    const std::vector<bench::input> corpus = { { "records=100000", "" } };
+    constexpr int kRecords = 100000;
+
+    r.run("response - std::string + write", corpus, [fd](const std::string&) {
+      std::string response;
+      for (int i = 0; i < kRecords; ++i) {
+        response += concat("id=", i, " element=battery value=", i * 0.5, "\n");
+      }
+      bench::do_not_optimize(::write(fd, response.data(), response.size()));
+    });
+
+    chunked_builder builder;
+    r.run("response - chunked_builder + writev", corpus, [fd, &builder](const std::string&) {
+      builder.clear();
+      for (int i = 0; i < kRecords; ++i) {
+        builder.append("id=", i, " element=battery value=", i * 0.5, "\n");
+      }
+      bench::do_not_optimize(builder.write_to(fd));
+    });
+    ::close(fd);
+  }
+#endif
+
+  if (output == "--csv") {
+    r.print_csv(std::cout);
+  } else if (output == "--json") {
+    r.print_json(std::cout);
+  } else {
+    r.print_table(std::cout);
+  }
+}
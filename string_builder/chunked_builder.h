@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include "code.h"
+
+// chunked (rope like) string builder for big responses
+// appends go into a list of fixed-size blocks, bytes once written are never moved or copied again,
+// result is written with writev (scatter-gather) without flattening to one contiguous string
+//   chunked_builder out;
+//   out.append("id=", 42, " name=", name).join(values, ",");
+//   out.write_to(fd);
+class chunked_builder {
+public:
+  explicit chunked_builder(std::size_t block_size = 64 * 1024) : block_size_(block_size) {
+  }
+
+  // strings, characters, integers and floating point, same arguments as concat
+  template <class... Args>
+  chunked_builder& append(const Args&... args) {
+    (append_one(args), ...);
+    return *this;
+  }
+
+  // same as join, elements go straight into blocks
+  template <class Range>
+  chunked_builder& join(const Range& range, std::string_view separator) {
+    bool first = true;
+    for (const auto& element : range) {
+      if (!first) append_view(separator);
+      first = false;
+      append_view(detail::join_view(element));
+    }
+    return *this;
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // drops content, keeps blocks for reuse
+  void clear() {
+    for (auto& b : blocks_) b.size = 0;
+    current_ = 0;
+    size_ = 0;
+  }
+
+  // calls fn(std::string_view) for every non-empty block in order
+  template <class F>
+  void for_each_block(F&& fn) const {
+    for (const auto& b : blocks_) {
+      if (b.size) fn(std::string_view(b.data.get(), b.size));
+    }
+  }
+
+  // flattens to one string, costs one copy of everything
+  std::string str() const {
+    std::string result;
+    result.reserve(size_);
+    for_each_block([&](std::string_view block) { result.append(block.data(), block.size()); });
+    return result;
+  }
+
+#if !defined(_WIN32)
+  // iovec for every non-empty block, valid until next append/clear
+  std::vector<iovec> iovecs() const {
+    std::vector<iovec> result;
+    result.reserve(blocks_.size());
+    for_each_block([&](std::string_view block) {
+      result.push_back({ const_cast<char*>(block.data()), block.size() });
+    });
+    return result;
+  }
+
+  // writes everything with writev, retries partial writes and EINTR
+  // returns false on write error (see errno)
+  bool write_to(int fd) const {
+    std::vector<iovec> iov = iovecs();
+    std::size_t first = 0;
+    while (first < iov.size()) {
+      const int count = static_cast<int>(std::min<std::size_t>(iov.size() - first, IOV_MAX));
+      ssize_t written = ::writev(fd, iov.data() + first, count);
+      if (written < 0) {
+        if (errno == EINTR) continue;
+        return false;
+      }
+      // skip fully written buffers, advance into partially written one
+      auto remaining = static_cast<std::size_t>(written);
+      while (first < iov.size() && remaining >= iov[first].iov_len) {
+        remaining -= iov[first].iov_len;
+        ++first;
+      }
+      if (remaining) {
+        iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + remaining;
+        iov[first].iov_len -= remaining;
+      }
+    }
+    return true;
+  }
+#endif
+
+private:
+  struct block {
+    std::unique_ptr<char[]> data;
+    std::size_t size;
+    std::size_t capacity;
+  };
+
+  template <class T>
+  void append_one(const T& value) {
+    if constexpr (!detail::is_concat_direct_v<T>) {
+      append_view(detail::concat_arg(value));
+    } else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*> || detail::is_string_like_v<T>) {
+      append_view(detail::join_view(value));
+    } else {
+      // numbers and characters are short, written in place if upper bound fits in current block
+      const std::size_t bound = detail::concat_size(value);
+      char* out = room(bound);
+      commit(detail::concat_write(out, out + bound, value) - out);
+    }
+  }
+
+  // copies str, splitting it over as many blocks as needed
+  void append_view(std::string_view str) {
+    while (!str.empty()) {
+      char* out = room(1);
+      const block& b = blocks_[current_];
+      const std::size_t count = std::min(str.size(), b.capacity - b.size);
+      std::memcpy(out, str.data(), count);
+      commit(count);
+      str.remove_prefix(count);
+    }
+  }
+
+  // pointer to at least bytes of contiguous free space in current block
+  // full block is left as is, appends continue in next (reused or new) block
+  char* room(std::size_t bytes) {
+    if (current_ < blocks_.size()) {
+      const block& b = blocks_[current_];
+      if (b.capacity - b.size >= bytes) return blocks_[current_].data.get() + b.size;
+      if (b.size) ++current_;
+    }
+    if (current_ == blocks_.size() || blocks_[current_].capacity < bytes) {
+      // only an item wider than block_size_ gets a longer block
+      const std::size_t capacity = std::max(bytes, block_size_);
+      blocks_.insert(blocks_.begin() + current_, block{ std::unique_ptr<char[]>(new char[capacity]), 0, capacity });
+    }
+    return blocks_[current_].data.get() + blocks_[current_].size;
+  }
+
+  void commit(std::size_t bytes) {
+    blocks_[current_].size += bytes;
+    size_ += bytes;
+  }
+
+  std::size_t block_size_;
+  std::vector<block> blocks_;
+  std::size_t current_ = 0;  // block receiving appends
+  std::size_t size_ = 0;
+};
@@ -1,53 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+  namespace detail {
+    template <class T>
+    constexpr bool is_string_like_v = std::is_convertible_v<const T&, std::string_view> && !std::is_same_v<T, std::nullptr_t>;
+
+    template <class T>
+    constexpr bool is_char_v = std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>;
+
+    // written directly, without stream
+    template <class T>
+    constexpr bool is_concat_direct_v = is_string_like_v<T> || std::is_arithmetic_v<T>;
+
+    // any other type (enums, pointers, user types) is converted once through operator<<
+    template <class T>
+    decltype(auto) concat_arg(const T& value) {
+      if constexpr (is_concat_direct_v<T>) {
+        return value;
+      } else {
+        std::ostringstream str;
+        str << value;
+        return str.str();
+      }
+    }
+
+    // upper bound of characters written for value, exact for strings
+    template <class T>
+    std::size_t concat_size(const T& value) {
+      if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+        return value ? std::strlen(value) : 0;
+      } else if constexpr (is_string_like_v<T>) {
+        return std::string_view(value).size();
+      } else if constexpr (is_char_v<T> || std::is_same_v<T, bool>) {
+        return 1;
+      } else if constexpr (std::is_integral_v<T>) {
+        return std::numeric_limits<T>::digits10 + 2;  // all digits and sign
+      } else if constexpr (std::is_floating_point_v<T>) {
+        // shortest round-trip form: sign, max_digits10 digits, point, exponent
+        return std::numeric_limits<T>::max_digits10 + 8;
+      } else {
+        static_assert(!sizeof(T), "concat_size supports strings, characters and numbers, pass other types through concat_arg");
+      }
+    }
+
+    // writes value to [out, last), returns end of written text
+    // out is returned unchanged when number doesn't fit, nothing is written then
+    template <class T>
+    char* concat_write(char* out, char* last, const T& value) {
+      if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+        if (!value) return out;
+        const std::size_t size = std::strlen(value);
+        std::memcpy(out, value, size);
+        return out + size;
+      } else if constexpr (is_string_like_v<T>) {
+        const std::string_view str(value);
+        std::memcpy(out, str.data(), str.size());
+        return out + str.size();
+      } else if constexpr (is_char_v<T>) {
+        *out = static_cast<char>(value);
+        return out + 1;
+      } else if constexpr (std::is_same_v<T, bool>) {
+        *out = value ? '1' : '0';  // same as ostream without boolalpha
+        return out + 1;
+      } else {
+        const auto [ptr, ec] = std::to_chars(out, last, value);
+        return ec == std::errc() ? ptr : out;
+      }
+    }
+
+    template <class... Args>
+    std::string concat_direct(const Args&... args) {
+      std::string result;
+      result.resize((concat_size(args) + ...));
+      char* out = result.data();
+      char* const last = out + result.size();
+      ((out = concat_write(out, last, args)), ...);
+      result.resize(out - result.data());
+      return result;
+    }
+  }  // namespace detail
+
+  // one allocation per call: size of all arguments is computed first, numbers are written with std::to_chars
+  // types other than strings, characters and numbers are formatted with operator<< as before
   template<class... Args>
   [[nodiscard]] std::string concat(const Args&... args)
   {
     if constexpr (sizeof...(args) == 0) {
       return {};
     } else {
-      std::ostringstream os;
-      ((os << args),...);
-      return os.str();
+      return detail::concat_direct(detail::concat_arg(args)...);
+    }
+  }
+
+  namespace detail {
+    template <class T>
+    std::string_view join_view(const T& value) {
+      if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+        return value ? std::string_view(value) : std::string_view();
+      } else {
+        static_assert(is_string_like_v<T>, "join supports ranges of strings, string_views and char pointers");
+        return std::string_view(value);
+      }
     }
+
+    // copies [first, last) with separator between elements to out, separator is written before every
+    // element except the one at begin of whole range
+    template <class It>
+    char* join_write(char* out, It first, It last, bool at_begin, std::string_view separator) {
+      for (; first != last; ++first) {
+        if (!at_begin) {
+          std::memcpy(out, separator.data(), separator.size());
+          out += separator.size();
+        }
+        at_begin = false;
+        const std::string_view str = join_view(*first);
+        std::memcpy(out, str.data(), str.size());
+        out += str.size();
+      }
+      return out;
+    }
+
+    template <class It>
+    std::size_t join_size(It first, It last, std::size_t& count) {
+      std::size_t size = 0;
+      for (; first != last; ++first, ++count) {
+        size += join_view(*first).size();
+      }
+      return size;
+    }
+  }  // namespace detail
+
+  enum class join_policy { sequential, parallel };
+
+  // concatenates with separator, any range of std::string, std::string_view or const char*
+  // output size is computed first, so the result is allocated exactly once
+  template <class Range>
+  [[nodiscard]] std::string join(const Range& range, std::string_view separator)
+  {
+    using std::begin;
+    using std::end;
+    std::size_t count = 0;
+    const std::size_t size = detail::join_size(begin(range), end(range), count);
+    if (count == 0) return {};
+
+    std::string result;
+    result.resize(size + (count - 1) * separator.size());
+    detail::join_write(result.data(), begin(range), end(range), true, separator);
+    return result;
   }
 
-// concatenates with separator
-std::string join(const std::vector<std::string>& a_vec, const char* separator) {
-  return std::accumulate(a_vec.begin(), a_vec.end(), std::string{},
-    [separator](const auto& str1, const auto& str2) {
-      return str1.empty() ? str2 : str1 + separator + str2;
-    });
-}
-
-// avoid re-allocations
-std::string join(const std::vector<std::string>& svec, const std::string& sepa) {
-	if (svec.empty())	return {};
-	/* calculate the overall size beforehand, to avoid re-allocations. */
-	size_t value_len =
-		std::accumulate(svec.cbegin(), svec.cend(), 0,
-				[](size_t size, const std::string& s) {
-					return size + s.size();
-				}) + (svec.size() - 1) * sepa.length();
-
-	std::string value;
-	value.reserve(value_len);
-
-	std::accumulate(svec.cbegin(), svec.cend(), std::ref(value),
-			[&](std::string& s1, const std::string& s2)->std::string& {
-				if (s1.empty())
-					s1 = s2;
-				else {
-					s1.append(sepa);
-					s1.append(s2);
-				}
-				return s1;
-			});
-
-	return value;
-}
-
-// std::next trick
-std::string join(const std::vector<std::string>& input, const char* separator) {
-    return input.empty() ? std::string() :
-      std::accumulate(std::next(input.begin()), input.end(), input.front(),
-      [separator](const auto& a, const auto& b) -> std::string { return a + separator + b; });
-}
+  // join_policy::parallel splits random access range into one slice per thread, lengths of every slice
+  // are summed in parallel, prefix sum of slice lengths gives each thread its offset in shared output
+  // small ranges are joined sequentially, thread start costs more than the copy
+  template <class Range>
+  [[nodiscard]] std::string join(const Range& range, std::string_view separator, join_policy policy, std::size_t thread_count = 0)
+  {
+    using std::begin;
+    using std::end;
+    using iterator = decltype(begin(range));
+    constexpr std::size_t kMinElementsPerThread = 1 << 16;
+
+    if constexpr (!std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<iterator>::iterator_category>) {
+      return join(range, separator);
+    } else {
+      const auto first = begin(range);
+      const std::size_t count = static_cast<std::size_t>(end(range) - first);
+      if (policy == join_policy::sequential || count < 2 * kMinElementsPerThread) return join(range, separator);
+      if (thread_count == 0) thread_count = std::thread::hardware_concurrency();
+      thread_count = std::min(thread_count, count / kMinElementsPerThread);
+      if (thread_count < 2) return join(range, separator);
+
+      auto slice = [&](std::size_t index) { return first + static_cast<std::ptrdiff_t>(count * index / thread_count); };
+      auto run = [&](auto&& task) {
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count - 1);
+        for (std::size_t i = 1; i < thread_count; ++i) {
+          threads.emplace_back(task, i);
+        }
+        task(0);
+        for (auto& t : threads) t.join();
+      };
+
+      // element lengths per slice, then exclusive prefix sum including separators
+      std::vector<std::size_t> offsets(thread_count + 1, 0);
+      run([&](std::size_t index) {
+        std::size_t elements = 0;
+        offsets[index + 1] = detail::join_size(slice(index), slice(index + 1), elements);
+      });
+      for (std::size_t i = 0; i < thread_count; ++i) {
+        const std::size_t elements = static_cast<std::size_t>(slice(i + 1) - slice(i));
+        offsets[i + 1] += offsets[i] + elements * separator.size();
+      }
+
+      std::string result;
+      result.resize(offsets.back() - separator.size());  // no separator before first element
+      run([&](std::size_t index) {
+        char* out = result.data() + (index ? offsets[index] - separator.size() : 0);
+        detail::join_write(out, slice(index), slice(index + 1), index == 0, separator);
+      });
+      return result;
+    }
+  }
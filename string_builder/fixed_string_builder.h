@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "code.h"
+
+// string builder with inline fixed capacity, no heap use unless overflow_policy::spill asks for it
+//   fixed_string_builder<64> line;
+//   line.append("id=", id, " value=", value);
+//   write(fd, line.data(), line.size());
+enum class overflow_policy {
+  truncate,  // keep what fits, overflowed() reports loss
+  error,     // append that doesn't fit changes nothing, overflowed() reports it
+  spill,     // move to heap std::string and keep going
+};
+
+namespace detail {
+  // longest text value of type T can produce, 0 when known only at run time
+  template <class T>
+  constexpr std::size_t static_size() {
+    if constexpr (std::is_array_v<T> && is_char_v<std::remove_extent_t<T>>) {
+      return std::extent_v<T> ? std::extent_v<T> - 1 : 0;  // literal without terminating NUL
+    } else if constexpr (is_char_v<T> || std::is_same_v<T, bool>) {
+      return 1;
+    } else if constexpr (std::is_integral_v<T>) {
+      return std::numeric_limits<T>::digits10 + 2;
+    } else if constexpr (std::is_floating_point_v<T>) {
+      return std::numeric_limits<T>::max_digits10 + 8;
+    } else {
+      return 0;
+    }
+  }
+
+  template <class T>
+  constexpr bool has_static_size_v = static_size<T>() != 0 || (std::is_array_v<T> && std::extent_v<T> == 1);
+}  // namespace detail
+
+template <std::size_t N, overflow_policy Policy = overflow_policy::truncate>
+class fixed_string_builder {
+public:
+  static_assert(N > 0, "fixed_string_builder needs capacity");
+
+  fixed_string_builder() { inline_[0] = '\0'; }
+
+  // strings, characters, integers and floating point, same arguments as concat
+  template <class... Args>
+  fixed_string_builder& append(const Args&... args) {
+    const std::size_t before = size();
+    const bool ok = (append_one(args) && ...);
+    if (!ok && Policy == overflow_policy::error) {
+      resize_inline(before);
+    }
+    return *this;
+  }
+
+  // same as append, but fails to compile when arguments can exceed capacity
+  // every argument must have size known from its type: literals, characters, numbers
+  template <class... Args>
+  fixed_string_builder& append_checked(const Args&... args) {
+    static_assert((detail::has_static_size_v<Args> && ...), "append_checked accepts only arguments with compile time size");
+    static_assert((detail::static_size<Args>() + ... + 0) <= N, "arguments can exceed fixed_string_builder capacity");
+    return append(args...);
+  }
+
+  // same as join
+  template <class Range>
+  fixed_string_builder& join(const Range& range, std::string_view separator) {
+    const std::size_t before = size();
+    bool first = true;
+    bool ok = true;
+    for (const auto& element : range) {
+      if (!first) ok = ok && append_view(separator);
+      first = false;
+      ok = ok && append_view(detail::join_view(element));
+    }
+    if (!ok && Policy == overflow_policy::error) {
+      resize_inline(before);
+    }
+    return *this;
+  }
+
+  const char* data() const {
+    if constexpr (Policy == overflow_policy::spill) {
+      if (heap_active_) return heap_.data();
+    }
+    return inline_;
+  }
+  const char* c_str() const { return data(); }
+  std::size_t size() const {
+    if constexpr (Policy == overflow_policy::spill) {
+      if (heap_active_) return heap_.size();
+    }
+    return size_;
+  }
+  bool empty() const { return size() == 0; }
+  static constexpr std::size_t capacity() { return N; }
+  std::string_view view() const { return std::string_view(data(), size()); }
+  operator std::string_view() const { return view(); }
+
+  // truncate and error policies: some append didn't fit
+  bool overflowed() const { return overflow_; }
+  // spill policy: content lives on heap
+  bool spilled() const {
+    if constexpr (Policy == overflow_policy::spill) {
+      return heap_active_;
+    } else {
+      return false;
+    }
+  }
+
+  void clear() {
+    resize_inline(0);
+    overflow_ = false;
+    if constexpr (Policy == overflow_policy::spill) {
+      heap_.clear();
+      heap_active_ = false;
+    }
+  }
+
+private:
+  template <class T>
+  bool append_one(const T& value) {
+    if constexpr (!detail::is_concat_direct_v<T>) {
+      return append_view(detail::concat_arg(value));
+    } else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*> || detail::is_string_like_v<T>) {
+      return append_view(detail::join_view(value));
+    } else {
+      // numbers and characters are written in place when upper bound fits
+      // they always produce some text, nothing written means to_chars failed and append fails
+      const std::size_t bound = detail::concat_size(value);
+      if (!spilled() && N - size_ >= bound) {
+        char* const out = inline_ + size_;
+        char* const end = detail::concat_write(out, inline_ + N, value);
+        if (end == out) return write_failed();
+        resize_inline(end - inline_);
+        return true;
+      }
+      char buffer[64];
+      char* const end = detail::concat_write(buffer, buffer + sizeof(buffer), value);
+      if (end == buffer) return write_failed();
+      return append_view(std::string_view(buffer, end - buffer));
+    }
+  }
+
+  bool append_view(std::string_view str) {
+    if constexpr (Policy == overflow_policy::spill) {
+      if (heap_active_) {
+        heap_.append(str.data(), str.size());
+        return true;
+      }
+    }
+    const std::size_t room = N - size_;
+    if (str.size() <= room) {
+      std::memcpy(inline_ + size_, str.data(), str.size());
+      resize_inline(size_ + str.size());
+      return true;
+    }
+
+    if constexpr (Policy == overflow_policy::spill) {
+      heap_.reserve(2 * N + str.size());
+      heap_.assign(inline_, size_);
+      heap_.append(str.data(), str.size());
+      heap_active_ = true;
+      return true;
+    } else {
+      if constexpr (Policy == overflow_policy::truncate) {
+        const std::string_view head = str.substr(0, room);
+        std::memcpy(inline_ + size_, head.data(), head.size());
+        resize_inline(N);
+      }
+      overflow_ = true;
+      return false;
+    }
+  }
+
+  bool write_failed() {
+    overflow_ = true;
+    return false;
+  }
+
+  void resize_inline(std::size_t size) {
+    size_ = size;
+    inline_[size_] = '\0';
+  }
+
+  struct none {};
+
+  char inline_[N + 1];
+  std::size_t size_ = 0;
+  bool overflow_ = false;
+  // heap storage only exists for spill policy
+  std::conditional_t<Policy == overflow_policy::spill, std::string, none> heap_;
+  std::conditional_t<Policy == overflow_policy::spill, bool, none> heap_active_{};
+};
+
+// concat into fixed capacity, arguments with compile time size are checked against N
+template <std::size_t N, overflow_policy Policy = overflow_policy::truncate, class... Args>
+fixed_string_builder<N, Policy> fixed_concat(const Args&... args) {
+  static_assert((detail::static_size<Args>() + ... + 0) <= N, "arguments can exceed fixed_string_builder capacity");
+  fixed_string_builder<N, Policy> result;
+  result.append(args...);
+  return result;
+}
@@ -0,0 +1,140 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+#include "code.h"
+#include "simplest_python_style_formating.h"
+#include "str_format.hpp"
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "../bench/benchmark.h"
+
+// formatters in this folder side by side, per argument kind
+// object code size per instantiation is measured separately by code_size.sh
+int main(int argc, char* argv[])
+{
+  // --csv or --json for machine readable output to track regressions between commits
+  const std::string output(argc > 1 ? argv[1] : "");
+
+  // input string is the string argument
+  bench::runner r({ { "short", "battery" }, { "long", std::string(200, 'x') } });
+
+  // values escape to do_not_optimize so calls aren't folded to constants
+  int int_value = 123456;
+  double float_value = 3.369;
+  bench::do_not_optimize(int_value);
+  bench::do_not_optimize(float_value);
+
+  // int
+  r.run("kt::format_str - int", [&](const std::string&) {
+    bench::do_not_optimize(kt::format_str("value={} of {}", int_value, -7));
+  });
+  static constexpr kt::parsed_fmt<2> kt_int("value={} of {}");
+  r.run("kt::format_str parsed - int", [&](const std::string&) {
+    bench::do_not_optimize(kt::format_str(kt_int, int_value, -7));
+  });
+  r.run("kt::format_to_n - int", [&](const std::string&) {
+    char buffer[256];
+    bench::do_not_optimize(kt::format_to_n(buffer, sizeof(buffer), kt_int, int_value, -7));
+  });
+  r.run("stdexp::format - int", [&](const std::string&) {
+    bench::do_not_optimize(stdexp::format("value={} of {}", int_value, -7));
+  });
+  r.run("stdexp::format_to_n - int", [&](const std::string&) {
+    char buffer[256];
+    bench::do_not_optimize(stdexp::format_to_n(buffer, sizeof(buffer), "value={} of {}", int_value, -7));
+  });
+  r.run("snprintf format - int", [&](const std::string&) {
+    bench::do_not_optimize(format("value=%d of %d", int_value, -7));
+  });
+  r.run("single_pass::format - int", [&](const std::string&) {
+    bench::do_not_optimize(single_pass::format("value=%d of %d", int_value, -7));
+  });
+#if defined(__cpp_lib_format)
+  r.run("std::format - int", [&](const std::string&) {
+    bench::do_not_optimize(std::format("value={} of {}", int_value, -7));
+  });
+#endif
+
+  // floating point, each in its default notation
+  r.run("kt::format_str - float", [&](const std::string&) {
+    bench::do_not_optimize(kt::format_str("value={} scale={}", float_value, 0.25));
+  });
+  r.run("stdexp::format - float", [&](const std::string&) {
+    bench::do_not_optimize(stdexp::format("value={} scale={}", float_value, 0.25));
+  });
+  r.run("std::to_string - float", [&](const std::string&) {
+    bench::do_not_optimize("value=" + std::to_string(float_value) + " scale=" + std::to_string(0.25));
+  });
+  r.run("snprintf format - float", [&](const std::string&) {
+    bench::do_not_optimize(format("value=%g scale=%g", float_value, 0.25));
+  });
+  r.run("single_pass::format - float", [&](const std::string&) {
+    bench::do_not_optimize(single_pass::format("value=%g scale=%g", float_value, 0.25));
+  });
+#if defined(__cpp_lib_format)
+  r.run("std::format - float", [&](const std::string&) {
+    bench::do_not_optimize(std::format("value={} scale={}", float_value, 0.25));
+  });
+#endif
+
+  // string
+  r.run("kt::format_str - string", [](const std::string& test) {
+    bench::do_not_optimize(kt::format_str("element: {}, state: {}", test, "ok"));
+  });
+  r.run("stdexp::format - string", [](const std::string& test) {
+    bench::do_not_optimize(stdexp::format("element: {}, state: {}", test, "ok"));
+  });
+  r.run("snprintf format - string", [](const std::string& test) {
+    bench::do_not_optimize(format("element: %s, state: %s", test.c_str(), "ok"));
+  });
+  r.run("single_pass::format - string", [](const std::string& test) {
+    bench::do_not_optimize(single_pass::format("element: %s, state: %s", test.c_str(), "ok"));
+  });
+#if defined(__cpp_lib_format)
+  r.run("std::format - string", [](const std::string& test) {
+    bench::do_not_optimize(std::format("element: {}, state: {}", test, "ok"));
+  });
+#endif
+
+  // mixed, typical log line
+  r.run("kt::format_str - mixed", [&](const std::string& test) {
+    bench::do_not_optimize(kt::format_str("id={:08x} element={} value={:.2f} count={}", int_value, test, float_value, 42u));
+  });
+  r.run("stdexp::format - mixed", [&](const std::string& test) {
+    bench::do_not_optimize(stdexp::format("id={:08x} element={} value={:.2f} count={}", int_value, test, float_value, 42u));
+  });
+  // format string from configuration: parsed per call, parsed once, parsed once and cached
+  const std::string dynamic_mixed("id={:08x} element={} value={:.2f} count={}");
+  const stdexp::format_template mixed_template(dynamic_mixed);
+  r.run("stdexp::format_template - mixed", [&](const std::string& test) {
+    bench::do_not_optimize(mixed_template.format(int_value, test, float_value, 42u));
+  });
+  r.run("stdexp::format_cached - mixed", [&](const std::string& test) {
+    bench::do_not_optimize(stdexp::format_cached(dynamic_mixed, int_value, test, float_value, 42u));
+  });
+  r.run("snprintf format - mixed", [&](const std::string& test) {
+    bench::do_not_optimize(format("id=%08x element=%s value=%.2f count=%u", int_value, test.c_str(), float_value, 42u));
+  });
+  r.run("single_pass::format - mixed", [&](const std::string& test) {
+    bench::do_not_optimize(single_pass::format("id=%08x element=%s value=%.2f count=%u", int_value, test.c_str(), float_value, 42u));
+  });
+#if defined(__cpp_lib_format)
+  r.run("std::format - mixed", [&](const std::string& test) {
+    bench::do_not_optimize(std::format("id={:08x} element={} value={:.2f} count={}", int_value, test, float_value, 42u));
+  });
+#endif
+
+  if (output == "--csv") {
+    r.print_csv(std::cout);
+  } else if (output == "--json") {
+    r.print_json(std::cout);
+  } else {
+    r.print_table(std::cout);
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <string_view>
+
+  template<class... Args>
+  std::string format(std::string message, Args&&... args) noexcept {
+    try {
+      size_t length = std::snprintf(nullptr, 0, message.c_str(), args...);
+      std::string out(length + 1, '\0');
+      std::snprintf(const_cast<char *>(out.data()), out.size(), message.c_str(), args...);
+      out.resize(length);  // drop terminating NUL written by snprintf
+      return out;
+    } catch (std::exception&) {
+      // We cannot log here, so return an empty string
+      return "";
+    }
+  }
+
+
+
+
+template <typename ...Args>
+std::string format(char const* fmt, Args&& ...args) {
+    auto const len(std::snprintf(nullptr, 0, fmt, std::forward<Args>(args)...));
+    if (len < 0) return {};  // encoding error
+    std::string ret(len + 1, '\0');
+    ret.resize(std::snprintf(ret.data(), ret.size(), fmt, std::forward<Args>(args)...));  // drop terminating NUL
+    return ret;
+}
+
+
+// one snprintf call when output fits stack buffer, second pass only for longer output
+namespace single_pass {
+  constexpr std::size_t SCRATCH_SIZE = 256;
+
+  template <typename ...Args>
+  std::string format(char const* fmt, Args ...args) {
+    char scratch[SCRATCH_SIZE];
+    auto const len = std::snprintf(scratch, sizeof(scratch), fmt, args...);
+    if (len < 0) return {};
+    if (static_cast<std::size_t>(len) < sizeof(scratch)) return std::string(scratch, len);
+
+    std::string ret(len, '\0');
+    std::snprintf(ret.data(), ret.size() + 1, fmt, args...);  // NUL goes to ret[len], which std::string keeps anyway
+    return ret;
+  }
+
+  // writes into caller buffer, no allocation, output is truncated to size - 1 and NUL terminated
+  // returns written characters, empty on encoding error
+  template <typename ...Args>
+  std::string_view format_to(char* buffer, std::size_t size, char const* fmt, Args ...args) {
+    if (size == 0) return {};
+    auto const len = std::snprintf(buffer, size, fmt, args...);
+    if (len < 0) return {};
+    return std::string_view(buffer, static_cast<std::size_t>(len) < size ? len : size - 1);
+  }
+
+  template <std::size_t N, typename ...Args>
+  std::string_view format_to(char (&buffer)[N], char const* fmt, Args ...args) {
+    return format_to(buffer, N, fmt, args...);
+  }
+}  // namespace single_pass
@@ -0,0 +1,76 @@
+// object code of 16 instantiations of one formatter, selected with -DFORMATTER_<NAME>
+// -DSINGLE_INSTANTIATION keeps only the first one, difference of both builds is the per call site cost
+// built and measured by code_size.sh, nothing to run
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#if defined(FORMATTER_KT) || defined(FORMATTER_KT_PARSED)
+#include "str_format.hpp"
+#elif defined(FORMATTER_STDEXP)
+#include "simplest_python_style_formating.h"
+#elif defined(FORMATTER_SNPRINTF) || defined(FORMATTER_SINGLE_PASS)
+#include "code.h"
+#elif defined(FORMATTER_STD_FORMAT)
+#include <format>
+#endif
+
+// argument types with printf conversion, each gives one single and one two argument instantiation
+#define ARGUMENT_TYPES(X)                       \
+  X(int, "%d")                                  \
+  X(unsigned, "%u")                             \
+  X(long long, "%lld")                          \
+  X(unsigned long long, "%llu")                 \
+  X(short, "%hd")                               \
+  X(char, "%c")                                 \
+  X(double, "%f")                               \
+  X(const char*, "%s")
+
+template <class T>
+T make(int argc, char** argv) {
+  if constexpr (std::is_pointer_v<T>) {
+    return argv[0];
+  } else {
+    return static_cast<T>(argc);
+  }
+}
+
+#if defined(FORMATTER_KT)
+#define FORMAT1(T, conversion) kt::format_str("a {} b", make<T>(argc, argv))
+#define FORMAT2(T, conversion) kt::format_str("a {} b {}", make<T>(argc, argv), 0.5)
+#elif defined(FORMATTER_KT_PARSED)
+static constexpr kt::parsed_fmt<1> fmt1("a {} b");
+static constexpr kt::parsed_fmt<2> fmt2("a {} b {}");
+#define FORMAT1(T, conversion) kt::format_str(fmt1, make<T>(argc, argv))
+#define FORMAT2(T, conversion) kt::format_str(fmt2, make<T>(argc, argv), 0.5)
+#elif defined(FORMATTER_STDEXP)
+#define FORMAT1(T, conversion) stdexp::format("a {} b", make<T>(argc, argv))
+#define FORMAT2(T, conversion) stdexp::format("a {} b {}", make<T>(argc, argv), 0.5)
+#elif defined(FORMATTER_SNPRINTF)
+#define FORMAT1(T, conversion) format("a " conversion " b", make<T>(argc, argv))
+#define FORMAT2(T, conversion) format("a " conversion " b %f", make<T>(argc, argv), 0.5)
+#elif defined(FORMATTER_SINGLE_PASS)
+#define FORMAT1(T, conversion) single_pass::format("a " conversion " b", make<T>(argc, argv))
+#define FORMAT2(T, conversion) single_pass::format("a " conversion " b %f", make<T>(argc, argv), 0.5)
+#elif defined(FORMATTER_STD_FORMAT)
+#define FORMAT1(T, conversion) std::format("a {} b", make<T>(argc, argv))
+#define FORMAT2(T, conversion) std::format("a {} b {}", make<T>(argc, argv), 0.5)
+#else
+// baseline: same calls returning empty string
+#define FORMAT1(T, conversion) std::string(make<T>(argc, argv) ? 0 : 1, 'a')
+#define FORMAT2(T, conversion) std::string(make<T>(argc, argv) ? 0 : 2, 'a')
+#endif
+
+#define INSTANTIATE(T, conversion)         \
+  size += FORMAT1(T, conversion).size();  \
+  size += FORMAT2(T, conversion).size();
+
+int main(int argc, char* argv[]) {
+  std::size_t size = 0;
+#if defined(SINGLE_INSTANTIATION)
+  size += FORMAT1(int, "%d").size();
+#else
+  ARGUMENT_TYPES(INSTANTIATE)
+#endif
+  return static_cast<int>(size);
+}
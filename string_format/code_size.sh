@@ -0,0 +1,29 @@
+#!/bin/sh
+# object code size per formatter instantiation
+# code_size.cpp is compiled per formatter with 1 and with 16 instantiations
+#   per instantiation: (text16 - text1) / 15, grows with every new call site
+#   fixed: text1 above baseline, first call site with everything shared (parser, helpers)
+#   CXX=clang++ CXXFLAGS="-std=c++20 -Os" ./code_size.sh
+set -u
+
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:--std=c++20 -O2}
+DIR=$(cd "$(dirname "$0")" && pwd)
+OBJ=$(mktemp)
+trap 'rm -f "$OBJ"' EXIT
+
+text_size() {
+  # shellcheck disable=SC2086
+  $CXX $CXXFLAGS -w -c "$DIR/code_size.cpp" "-DFORMATTER_$1" $2 -o "$OBJ" 2>/dev/null || return 1
+  size "$OBJ" | awk 'NR == 2 { print $1 }'
+}
+
+BASELINE=$(text_size BASELINE -DSINGLE_INSTANTIATION) || { echo "baseline build failed" >&2; exit 1; }
+printf '%-16s %12s %12s %18s %10s\n' formatter "text 1" "text 16" "per instantiation" fixed
+for formatter in KT KT_PARSED STDEXP SNPRINTF SINGLE_PASS STD_FORMAT; do
+  if TEXT1=$(text_size $formatter -DSINGLE_INSTANTIATION) && TEXT16=$(text_size $formatter ""); then
+    printf '%-16s %12d %12d %18d %10d\n' $formatter "$TEXT1" "$TEXT16" $(( (TEXT16 - TEXT1) / 15 )) $(( TEXT1 - BASELINE ))
+  else
+    printf '%-16s %12s %12s %18s %10s\n' $formatter n/a n/a n/a n/a
+  fi
+done
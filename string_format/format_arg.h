@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+// argument writers shared by the formatters in this folder
+// no streams and no allocations: numbers are written into a stack buffer,
+// text is copied straight to the output iterator
+namespace format_arg {
+  // format specifier, subset of std::format: {:[[fill]align][0][width][.precision][type]}
+  //   align: < left, > right, ^ center
+  //   type: d decimal, x X hexadecimal, b binary, f fixed, e scientific, g general, s string
+  struct spec {
+    char fill = ' ';
+    char align = 0;     // 0 - numbers right, strings left
+    bool zero = false;  // pad numbers with zeros after sign
+    unsigned width = 0;
+    int precision = -1;  // -1 - not set
+    char type = 0;       // 0 - default for argument type
+  };
+
+  constexpr unsigned max_precision = 128;
+
+  // text between ':' and '}', false when not a valid specifier
+  constexpr bool parse_spec(std::string_view text, spec& result) {
+    auto is_align = [](char c) { return c == '<' || c == '>' || c == '^'; };
+    auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+    std::size_t i = 0;
+    if (text.size() >= 2 && is_align(text[1])) {
+      result.fill = text[0];
+      result.align = text[1];
+      i = 2;
+    } else if (!text.empty() && is_align(text[0])) {
+      result.align = text[0];
+      i = 1;
+    }
+    if (i < text.size() && text[i] == '0') {
+      result.zero = true;
+      ++i;
+    }
+    for (; i < text.size() && is_digit(text[i]); ++i) {
+      result.width = result.width * 10 + (text[i] - '0');
+      if (result.width > 0xFFFF) return false;
+    }
+    if (i < text.size() && text[i] == '.') {
+      if (++i == text.size() || !is_digit(text[i])) return false;
+      unsigned precision = 0;
+      for (; i < text.size() && is_digit(text[i]); ++i) {
+        precision = precision * 10 + (text[i] - '0');
+        if (precision > max_precision) return false;
+      }
+      result.precision = static_cast<int>(precision);
+    }
+    if (i < text.size()) {
+      constexpr std::string_view types = "dxXbfegs";
+      if (types.find(text[i]) == std::string_view::npos) return false;
+      result.type = text[i++];
+    }
+    return i == text.size();
+  }
+
+  // placeholder "{}" or "{:spec}" in format string, any other brace is literal text
+  struct placeholder {
+    std::size_t begin = std::string_view::npos;  // npos - not found
+    std::size_t end = 0;                         // past closing brace
+    spec format;
+  };
+
+  constexpr placeholder find_placeholder(std::string_view fmt, std::size_t from = 0) {
+    for (auto pos = fmt.find('{', from); pos != std::string_view::npos && pos + 1 < fmt.size(); pos = fmt.find('{', pos + 1)) {
+      placeholder found;
+      if (fmt[pos + 1] == '}') {
+        found.begin = pos;
+        found.end = pos + 2;
+        return found;
+      }
+      if (fmt[pos + 1] == ':') {
+        const auto close = fmt.find('}', pos + 2);
+        if (close == std::string_view::npos) break;
+        if (parse_spec(fmt.substr(pos + 2, close - pos - 2), found.format)) {
+          found.begin = pos;
+          found.end = close + 1;
+          return found;
+        }
+      }
+    }
+    return {};
+  }
+
+  namespace detail {
+    // "00" "01" ... "99", decimal output two digits per division
+    struct digit_pairs {
+      char data[200];
+      constexpr digit_pairs() : data() {
+        for (int i = 0; i < 100; ++i) {
+          data[2 * i] = static_cast<char>('0' + i / 10);
+          data[2 * i + 1] = static_cast<char>('0' + i % 10);
+        }
+      }
+    };
+    inline constexpr digit_pairs pairs{};
+
+    // digits are written backwards ending at end, returns first digit
+    template <class U>
+    char* write_decimal(char* end, U value) {
+      while (value >= 100) {
+        end -= 2;
+        std::memcpy(end, pairs.data + (value % 100) * 2, 2);
+        value /= 100;
+      }
+      if (value >= 10) {
+        end -= 2;
+        std::memcpy(end, pairs.data + value * 2, 2);
+      } else {
+        *--end = static_cast<char>('0' + value);
+      }
+      return end;
+    }
+
+    // base 2 or 16
+    template <class U>
+    char* write_power_of_two(char* end, U value, unsigned shift, const char* digits) {
+      const U mask = (U(1) << shift) - 1;
+      do {
+        *--end = digits[value & mask];
+        value >>= shift;
+      } while (value);
+      return end;
+    }
+  }  // namespace detail
+
+  template <class OutputIt>
+  OutputIt write(OutputIt out, std::string_view str) {
+    return std::copy(str.begin(), str.end(), out);
+  }
+
+  // body padded to spec width, sign_size leading characters stay in front of zero padding
+  template <class OutputIt>
+  OutputIt write_padded(OutputIt out, std::string_view body, const spec& format, char default_align, std::size_t sign_size = 0) {
+    if (format.width <= body.size()) return write(out, body);
+    const std::size_t padding = format.width - body.size();
+    if (format.zero && !format.align && default_align == '>') {
+      out = write(out, body.substr(0, sign_size));
+      out = std::fill_n(out, padding, '0');
+      return write(out, body.substr(sign_size));
+    }
+    const char align = format.align ? format.align : default_align;
+    const std::size_t left = align == '>' ? padding : align == '^' ? padding / 2 : 0;
+    out = std::fill_n(out, left, format.fill);
+    out = write(out, body);
+    return std::fill_n(out, padding - left, format.fill);
+  }
+
+  // precision limits number of characters
+  template <class OutputIt>
+  OutputIt write_string(OutputIt out, std::string_view str, const spec& format = {}) {
+    if (format.precision >= 0 && str.size() > static_cast<std::size_t>(format.precision)) {
+      str = str.substr(0, format.precision);
+    }
+    return write_padded(out, str, format, '<');
+  }
+
+  template <class OutputIt, class T>
+  OutputIt write_integer(OutputIt out, T value, const spec& format = {}) {
+    static_assert(std::is_integral_v<T>, "write_integer needs integer");
+    using U = std::make_unsigned_t<T>;
+    const bool negative = value < 0;
+    const U magnitude = negative ? U(0) - static_cast<U>(value) : static_cast<U>(value);
+
+    char buffer[std::numeric_limits<U>::digits + 1];  // base 2 worst case and sign
+    char* const end = buffer + sizeof(buffer);
+    char* begin;
+    switch (format.type) {
+      case 'x': begin = detail::write_power_of_two(end, magnitude, 4, "0123456789abcdef"); break;
+      case 'X': begin = detail::write_power_of_two(end, magnitude, 4, "0123456789ABCDEF"); break;
+      case 'b': begin = detail::write_power_of_two(end, magnitude, 1, "01"); break;
+      default: begin = detail::write_decimal(end, magnitude); break;
+    }
+    if (negative) *--begin = '-';
+    // fast path for plain {}
+    if (format.width == 0) return write(out, std::string_view(begin, end - begin));
+    return write_padded(out, std::string_view(begin, end - begin), format, '>', negative ? 1 : 0);
+  }
+
+  // shortest text that parses back to the same value (to_chars without precision, Ryu class algorithm),
+  // fixed or scientific whichever is shorter: 3.369, 1900, 1e+20
+  // no locale, faster than snprintf %g and std::to_string
+  template <class OutputIt, class T>
+  OutputIt write_float(OutputIt out, T value) {
+    char buffer[64];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    return write(out, std::string_view(buffer, result.ptr - buffer));
+  }
+
+  // no type and no precision: shortest round-trip
+  // type f, e or g with precision (6 when not set), no type with precision is g
+  template <class OutputIt, class T>
+  OutputIt write_float(OutputIt out, T value, const spec& format) {
+    if (format.type == 0 && format.precision < 0 && format.width == 0) return write_float(out, value);
+
+    // fixed format of largest value needs all integer digits
+    char buffer[std::numeric_limits<T>::max_exponent10 + std::numeric_limits<T>::max_digits10 + max_precision + 16];
+    std::to_chars_result result;
+    if (format.type == 0 && format.precision < 0) {
+      result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    } else {
+      const std::chars_format chars_format = format.type == 'f' ? std::chars_format::fixed
+                                           : format.type == 'e' ? std::chars_format::scientific
+                                                                : std::chars_format::general;
+      result = std::to_chars(buffer, buffer + sizeof(buffer), value, chars_format, format.precision >= 0 ? format.precision : 6);
+    }
+    const std::string_view body(buffer, result.ptr - buffer);
+    // no zero padding for inf and nan
+    spec padding = format;
+    padding.zero = format.zero && (body.back() >= '0' && body.back() <= '9');
+    return write_padded(out, body, padding, '>', body[0] == '-' ? 1 : 0);
+  }
+
+  template <class OutputIt>
+  OutputIt write_pointer(OutputIt out, const void* ptr, const spec& format = {}) {
+    char buffer[2 + 2 * sizeof(void*)];
+    char* const end = buffer + sizeof(buffer);
+    char* begin = detail::write_power_of_two(end, reinterpret_cast<std::uintptr_t>(ptr), 4, "0123456789abcdef");
+    *--begin = 'x';
+    *--begin = '0';
+    return write_padded(out, std::string_view(begin, end - begin), format, '>', 2);
+  }
+
+  // output iterator for format_to_n: stores first n characters, counts all of them
+  class truncating_iterator {
+  public:
+    using iterator_category = std::output_iterator_tag;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = void;
+
+    truncating_iterator(char* out, std::size_t n) : out_(out), n_(n) {}
+
+    truncating_iterator& operator=(char c) {
+      if (count_ < n_) out_[count_] = c;
+      ++count_;
+      return *this;
+    }
+    truncating_iterator& operator*() { return *this; }
+    truncating_iterator& operator++() { return *this; }
+    truncating_iterator& operator++(int) { return *this; }
+
+    // bulk copy for whole strings
+    void append(std::string_view str) {
+      if (count_ < n_) {
+        std::memcpy(out_ + count_, str.data(), std::min(str.size(), n_ - count_));
+      }
+      count_ += str.size();
+    }
+
+    char* out() const { return out_ + std::min(count_, n_); }
+    std::size_t count() const { return count_; }
+
+  private:
+    char* out_;
+    std::size_t n_;
+    std::size_t count_ = 0;
+  };
+
+  inline truncating_iterator write(truncating_iterator out, std::string_view str) {
+    out.append(str);
+    return out;
+  }
+
+  // same as std::format_to_n_result: end of written characters and untruncated size
+  struct format_to_n_result {
+    char* out;
+    std::size_t size;
+  };
+}  // namespace format_arg
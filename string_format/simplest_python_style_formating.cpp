@@ -1,90 +1,8 @@
-#include <type_traits>
-#include <string>
-#include <sstream>
-
-namespace stdexp {
-  namespace detail {
-    // define traits for string formating
-    //-----------------------------------------------------------------------------
-    template <typename T, typename = void>
-    struct is_to_string_able : std::false_type {};
-
-    template <typename T>
-    struct is_to_string_able<T, std::void_t<decltype(std::to_string(std::declval<T>()))>> : std::true_type {};
-
-    //-----------------------------------------------------------------------------
-    template<typename S, typename V>
-    using streamability = decltype(std::declval<S&>() << std::declval<const V&>());
-
-    template<typename S, typename V, class = void>
-    struct is_stream_able : std::false_type {};
-
-    template<typename S, typename V>
-    struct is_stream_able<S, V, std::void_t<streamability<S, V>>> : std::true_type {};
-    //-----------------------------------------------------------------------------
-
-    // convert arguments to string
-    template <typename T>
-    [[nodiscard]] std::string to_string(T&& value) {
-      if constexpr (std::is_same<std::decay_t<T>, std::string>::value) {
-        return value;
-      } else if constexpr (is_to_string_able<std::decay_t<T>>::value) {
-        return std::to_string(std::forward<T>(value));
-      } else if constexpr (is_stream_able<std::stringstream, std::decay_t<T>>::value) {
-        std::stringstream ss;
-        ss << value;
-        return ss.str();
-      } else {
-        // Unsupported type, require custom implementation of "to_string"
-        static_assert(false, "Unsupported type");
-      }
-    }
-
-    // replace std::string with std::string_view once available
-    [[nodiscard]] std::string format(const std::string& fmt, const std::initializer_list<std::string>& args);
-
-  }  // namespace detail
-
-  template <typename... Args>
-  [[nodiscard]] std::string format(const std::string& fmt, Args&&... args) {
-    return detail::format(fmt, { detail::to_string(std::forward<Args>(args))... });
-  }
-}  // namespace stdexp
-
-#include <numeric>
-
-namespace stdexp {
-  namespace detail {
-    // The size of the placeholder in the format function.
-    constexpr std::size_t PLACEHOLDER_SIZE = 2;
-
-    std::string format(const std::string& fmt, const std::initializer_list<std::string>& args) {
-      std::size_t pos = 0;
-      std::string result{ fmt };
-
-      auto const size = fmt.size() +
-        std::accumulate(args.begin(), args.end(), std::size_t{ 0u },
-          [](std::size_t c, auto const& str) { return c + str.size(); });
-      result.reserve(size);
-
-      for (const auto& arg : args) {
-        pos = result.find("{}", pos);
-        if (std::string::npos == pos) {
-          // "Not enough placeholders found"
-          break;
-        }
-
-        result.replace(pos, PLACEHOLDER_SIZE, arg);
-        pos += arg.size();
-      }
-
-      return result;
-    }
-  }  // namespace detail
-}  // namespace stdexp
+#include <iostream>
+#include <iterator>
 
+#include "simplest_python_style_formating.h"
 
-#include <iostream>
 int main() {
   std::cout << "Hello World!\n" << std::endl;
 
@@ -108,7 +26,7 @@ int main() {
   std::cout << stdexp::format("{}", double(-23.0)) << ": " <<"-23" << std::endl;
   std::cout << stdexp::format("{}", float(3.369)) << ": " <<"3.369" << std::endl;
   std::cout << stdexp::format("{}", double(-3.369)) << ": " <<"-3.369" << std::endl;
-  std::cout << stdexp::format("{}", long double(123456.654321)) << ": " <<"123456.654321" << std::endl;
+  std::cout << stdexp::format("{}", 123456.654321L) << ": " <<"123456.654321" << std::endl;
   std::cout << stdexp::format("{}", bool(0)) << ": " <<"false" << std::endl;
   std::cout << stdexp::format("{}", bool(1)) << ": " <<"true" << std::endl;
 
@@ -120,5 +38,25 @@ int main() {
   // stream formating
   void* ptr(nullptr);
   std::cout << stdexp::format("{}", ptr) << ": " <<"00000000" << std::endl;
+
+  // into reused buffer, no allocations
+  char buffer[64];
+  auto written = stdexp::format_to_n(buffer, sizeof(buffer), "{} of {} at {}", 3, 7u, double(-3.369));
+  std::cout << std::string_view(buffer, written.out - buffer) << ": " << "3 of 7 at -3.369" << std::endl;
+  std::string out;
+  stdexp::format_to(std::back_inserter(out), "id={} name={}", 42, "battery");
+  std::cout << out << ": " << "id=42 name=battery" << std::endl;
+
+  // runtime format string parsed once
+  const std::string configured("{:>5}|{:<5}|");
+  stdexp::format_template parsed(configured);
+  std::cout << parsed.format(1, 2) << ": " << "    1|2    |" << std::endl;
+  std::cout << stdexp::format_cached(configured, 3, 4) << ": " << "    3|4    |" << std::endl;
+
+  // format specifiers
+  std::cout << stdexp::format("{:x} {:X} {:b}", 255, 255, 5) << ": " << "ff FF 101" << std::endl;
+  std::cout << stdexp::format("[{:>6}][{:<6}][{:^6}][{:*>6}]", 42, 42, 42, "ab") << ": " << "[    42][42    ][  42  ][****ab]" << std::endl;
+  std::cout << stdexp::format("{:08x} {:06}", 0xbeef, -42) << ": " << "0000beef -00042" << std::endl;
+  std::cout << stdexp::format("{:.2f} {:.3e} {:g}", 3.14159, 12345.678, 0.0001) << ": " << "3.14 1.235e+04 0.0001" << std::endl;
 }
 
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <type_traits>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iterator>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "format_arg.h"
+
+namespace stdexp {
+  namespace detail {
+    // define traits for string formating
+    //-----------------------------------------------------------------------------
+    template <typename T, typename = void>
+    struct is_to_string_able : std::false_type {};
+
+    template <typename T>
+    struct is_to_string_able<T, std::void_t<decltype(std::to_string(std::declval<T>()))>> : std::true_type {};
+
+    //-----------------------------------------------------------------------------
+    template<typename S, typename V>
+    using streamability = decltype(std::declval<S&>() << std::declval<const V&>());
+
+    template<typename S, typename V, class = void>
+    struct is_stream_able : std::false_type {};
+
+    template<typename S, typename V>
+    struct is_stream_able<S, V, std::void_t<streamability<S, V>>> : std::true_type {};
+    //-----------------------------------------------------------------------------
+
+    // convert arguments to string
+    template <typename T>
+    [[nodiscard]] std::string to_string(T&& value) {
+      if constexpr (std::is_same<std::decay_t<T>, std::string>::value) {
+        return value;
+      } else if constexpr (is_to_string_able<std::decay_t<T>>::value) {
+        return std::to_string(std::forward<T>(value));
+      } else if constexpr (is_stream_able<std::stringstream, std::decay_t<T>>::value) {
+        std::stringstream ss;
+        ss << value;
+        return ss.str();
+      } else {
+        // Unsupported type, require custom implementation of "to_string"
+        static_assert(!sizeof(T), "Unsupported type");
+      }
+    }
+
+    // writes argument as to_string above would, floating point in shortest round-trip form instead of %f
+    // strings, booleans, numbers and pointers without temporary string
+    template <typename OutputIt, typename T>
+    OutputIt write_value(OutputIt out, const T& value, const format_arg::spec& spec) {
+      if constexpr (std::is_same<T, const char*>::value || std::is_same<T, char*>::value) {
+        return value ? format_arg::write_string(out, value, spec) : out;
+      } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+        return format_arg::write_string(out, std::string_view(value), spec);
+      } else if constexpr (std::is_same<T, bool>::value) {
+        return format_arg::write_integer(out, static_cast<int>(value), spec);
+      } else if constexpr (std::is_integral<T>::value) {
+        if (spec.type == 'f' || spec.type == 'e' || spec.type == 'g') {
+          return format_arg::write_float(out, static_cast<double>(value), spec);
+        }
+        return format_arg::write_integer(out, value, spec);
+      } else if constexpr (std::is_floating_point<T>::value) {
+        return format_arg::write_float(out, value, spec);  // shortest round-trip by default, {:.3} is general as in kt
+      } else if constexpr (std::is_pointer<T>::value) {
+        return format_arg::write_pointer(out, value, spec);
+      } else {
+        return format_arg::write_string(out, to_string(value), spec);
+      }
+    }
+  }  // namespace detail
+
+  // same output as format, written straight to out without streams or temporary strings
+  // placeholder is {} or {:[[fill]align][0][width][.precision][type]}, type one of d x X b f e g s
+  // returns iterator past the last written character
+  template <typename OutputIt, typename... Args>
+  OutputIt format_to(OutputIt out, std::string_view fmt, const Args&... args) {
+    bool done = false;
+    [[maybe_unused]] auto write_arg = [&](const auto& arg) {
+      if (done) return;
+      const auto placeholder = format_arg::find_placeholder(fmt);
+      if (std::string_view::npos == placeholder.begin) {
+        // "Not enough placeholders found"
+        done = true;
+        return;
+      }
+      out = detail::write_value(format_arg::write(out, fmt.substr(0, placeholder.begin)), arg, placeholder.format);
+      fmt.remove_prefix(placeholder.end);
+    };
+    (write_arg(args), ...);
+    return format_arg::write(out, fmt);
+  }
+
+  // writes at most n characters, no terminating NUL
+  // returns end of written characters and size of untruncated output
+  template <typename... Args>
+  format_arg::format_to_n_result format_to_n(char* out, std::size_t n, std::string_view fmt, const Args&... args) {
+    const auto it = format_to(format_arg::truncating_iterator(out, n), fmt, args...);
+    return { it.out(), it.count() };
+  }
+
+  template <typename... Args>
+  [[nodiscard]] std::string format(std::string_view fmt, const Args&... args) {
+    std::string result;
+    result.reserve(fmt.size());
+    format_to(std::back_inserter(result), fmt, args...);
+    return result;
+  }
+
+  // format string parsed once at run time, for formats that come from configuration
+  // same output as format, placeholders and literal segments are not searched again on every call
+  class format_template {
+  public:
+    explicit format_template(std::string fmt) : fmt_(std::move(fmt)) {
+      for (auto placeholder = format_arg::find_placeholder(fmt_); std::string_view::npos != placeholder.begin;
+           placeholder = format_arg::find_placeholder(fmt_, placeholder.end)) {
+        placeholders_.push_back(placeholder);
+      }
+    }
+
+    std::string_view str() const { return fmt_; }
+    std::size_t placeholders() const { return placeholders_.size(); }
+
+    template <typename OutputIt, typename... Args>
+    OutputIt format_to(OutputIt out, const Args&... args) const {
+      const std::string_view fmt(fmt_);
+      std::size_t i = 0;
+      std::size_t literal_begin = 0;
+      [[maybe_unused]] auto write_arg = [&](const auto& arg) {
+        // "Not enough placeholders found"
+        if (i == placeholders_.size()) return;
+        const auto& placeholder = placeholders_[i++];
+        out = format_arg::write(out, fmt.substr(literal_begin, placeholder.begin - literal_begin));
+        out = detail::write_value(out, arg, placeholder.format);
+        literal_begin = placeholder.end;
+      };
+      (write_arg(args), ...);
+      return format_arg::write(out, fmt.substr(literal_begin));
+    }
+
+    template <typename... Args>
+    format_arg::format_to_n_result format_to_n(char* out, std::size_t n, const Args&... args) const {
+      const auto it = format_to(format_arg::truncating_iterator(out, n), args...);
+      return { it.out(), it.count() };
+    }
+
+    template <typename... Args>
+    [[nodiscard]] std::string format(const Args&... args) const {
+      std::string result;
+      result.reserve(fmt_.size());
+      format_to(std::back_inserter(result), args...);
+      return result;
+    }
+
+  private:
+    std::string fmt_;
+    std::vector<format_arg::placeholder> placeholders_;
+  };
+
+  namespace detail {
+    // thread safe cache of parsed templates, entries live until exit
+    // meant for the bounded set of formats a program reads from configuration, new formats are not cached once full
+    class template_cache {
+    public:
+      static constexpr std::size_t MAX_TEMPLATES = 1024;
+
+      static template_cache& instance() {
+        static template_cache cache;
+        return cache;
+      }
+
+      // nullptr when fmt isn't cached and cache is full
+      const format_template* find(std::string_view fmt) {
+        // same format string object as last call on this thread: no hashing, no lock
+        thread_local const char* last_data = nullptr;
+        thread_local const format_template* last = nullptr;
+        if (last && fmt.data() == last_data && last->str().size() == fmt.size() &&
+            std::memcmp(last->str().data(), fmt.data(), fmt.size()) == 0) {
+          return last;
+        }
+
+        const format_template* found = lookup(fmt);
+        if (found) {
+          last_data = fmt.data();
+          last = found;
+        }
+        return found;
+      }
+
+    private:
+      const format_template* lookup(std::string_view fmt) {
+        {
+          std::shared_lock<std::shared_mutex> lock(mutex_);
+          const auto it = templates_.find(fmt);
+          if (it != templates_.end()) return it->second.get();
+          if (templates_.size() == MAX_TEMPLATES) return nullptr;  // full, don't parse what can't be stored
+        }
+        auto parsed = std::make_unique<format_template>(std::string(fmt));
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        const auto it = templates_.find(fmt);
+        if (it != templates_.end()) return it->second.get();  // parsed by other thread meanwhile
+        if (templates_.size() == MAX_TEMPLATES) return nullptr;
+        const format_template* result = parsed.get();
+        templates_.emplace(result->str(), std::move(parsed));  // key points into owned copy
+        return result;
+      }
+
+      std::shared_mutex mutex_;
+      std::unordered_map<std::string_view, std::unique_ptr<format_template>> templates_;
+    };
+  }  // namespace detail
+
+  // format with runtime format string parsed on first use and cached
+  template <typename... Args>
+  [[nodiscard]] std::string format_cached(std::string_view fmt, const Args&... args) {
+    if (const format_template* parsed = detail::template_cache::instance().find(fmt)) {
+      return parsed->format(args...);
+    }
+    return format(fmt, args...);
+  }
+}  // namespace stdexp
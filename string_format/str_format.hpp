@@ -2,38 +2,250 @@
 // Requirements: C++17
 
 #pragma once
+#include "format_arg.h"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
 #include <ostream>
 #include <sstream>
+#include <stdexcept>
 #include <string_view>
+#include <type_traits>
 
 namespace kt {
 ///
 /// \brief Format token
+/// Placeholder is fmt_token or "{:spec}" with spec [[fill]align][0][width][.precision][type]
+/// align: < > ^, type: d x X b (integers), f e g (floating point), s (strings)
 ///
 constexpr std::string_view fmt_token = "{}";
 
+///
+/// \brief Format string split into literal segments around exactly N placeholders
+/// Parsed once in constant evaluation: placeholder count other than N is a compile error
+/// \code
+/// constexpr kt::parsed_fmt<2> fmt("x={} y={}");
+/// kt::format_str(fmt, x, y);
+/// \endcode
+///
+template <std::size_t N>
+class parsed_fmt {
+  public:
+	constexpr explicit parsed_fmt(std::string_view fmt) {
+		std::size_t count = 0;
+		std::size_t start = 0;
+		for (auto p = format_arg::find_placeholder(fmt); p.begin != std::string_view::npos; p = format_arg::find_placeholder(fmt, start)) {
+			if (count == N) { throw std::invalid_argument("kt::parsed_fmt: more placeholders than arguments"); }
+			m_specs[count] = p.format;
+			m_literals[count++] = fmt.substr(start, p.begin - start);
+			start = p.end;
+		}
+		if (count != N) { throw std::invalid_argument("kt::parsed_fmt: fewer placeholders than arguments"); }
+		m_literals[N] = fmt.substr(start);
+	}
+
+	///
+	/// \brief Literal text before placeholder i, literal(N) is the text after the last one
+	///
+	constexpr std::string_view literal(std::size_t i) const { return m_literals[i]; }
+	///
+	/// \brief Format specifier of placeholder i
+	///
+	constexpr format_arg::spec const& spec(std::size_t i) const { return m_specs[i]; }
+	static constexpr std::size_t size() { return N; }
+
+  private:
+	std::array<std::string_view, N + 1> m_literals{};
+	std::array<format_arg::spec, N> m_specs{};
+};
+
+namespace detail {
+#if defined(__cpp_consteval)
+constexpr bool literal_checked = true;
+#else
+constexpr bool literal_checked = false;
+#endif
+
+///
+/// \brief Formats taking the runtime (find based) path: anything convertible to string_view, except C++20 literals
+///
+template <typename Fmt>
+constexpr bool is_runtime_fmt_v = std::is_convertible_v<Fmt const&, std::string_view> && !(literal_checked && std::is_array_v<Fmt>);
+} // namespace detail
+
+#if defined(__cpp_consteval)
+///
+/// \brief String literal checked against argument types at compile time (C++20)
+///
+template <typename... Args>
+struct format_string : parsed_fmt<sizeof...(Args)> {
+	template <std::size_t M>
+	consteval format_string(char const (&fmt)[M]) : parsed_fmt<sizeof...(Args)>(std::string_view(fmt, M - 1)) {}
+};
+
+///
+/// \brief Obtain formatted string from literal format parsed at compile time (C++20)
+///
+template <typename... Args>
+std::string format_str(format_string<std::type_identity_t<Args>...> fmt, Args const&... args);
+#endif
+
 ///
 /// \brief Obtain formatted string
 /// \param fmt Interpolated string format (only exact fmt_token literal supported for direct argument replacement)
 /// \param args Arguments
+/// With C++20 string literals go to the compile time checked overload
+///
+template <typename Fmt, typename... Args>
+auto format_str(Fmt const& fmt, Args const&... args) -> std::enable_if_t<detail::is_runtime_fmt_v<Fmt>, std::string>;
+
+///
+/// \brief Obtain formatted string from pre-parsed format
+///
+template <std::size_t N, typename... Args>
+std::string format_str(parsed_fmt<N> const& fmt, Args const&... args);
+
+///
+/// \brief Write formatted output to iterator without streams or allocations
+/// \param out Output iterator accepting char
+/// \param fmt Runtime format, parsed_fmt<N> or (C++20) compile time checked literal
+/// \param args Strings, characters, booleans, integers and pointers printed as std::ostream would,
+/// floating point in shortest round-trip form, other types through operator<<
+/// \returns Iterator past the last written character
+///
+template <typename OutputIt, typename Fmt, typename... Args>
+auto format_to(OutputIt out, Fmt const& fmt, Args const&... args) -> std::enable_if_t<detail::is_runtime_fmt_v<Fmt>, OutputIt>;
+
+template <typename OutputIt, std::size_t N, typename... Args>
+OutputIt format_to(OutputIt out, parsed_fmt<N> const& fmt, Args const&... args);
+
+///
+/// \brief Write at most n characters of formatted output to buffer, no terminating NUL
+/// \returns End of written characters and size of complete output
 ///
+template <typename Fmt, typename... Args>
+auto format_to_n(char* out, std::size_t n, Fmt const& fmt, Args const&... args)
+	-> std::enable_if_t<!(detail::literal_checked && std::is_array_v<Fmt>), format_arg::format_to_n_result>;
+
+#if defined(__cpp_consteval)
+template <typename OutputIt, typename... Args>
+OutputIt format_to(OutputIt out, format_string<std::type_identity_t<Args>...> fmt, Args const&... args);
+
 template <typename... Args>
-std::string format_str(std::string_view fmt, Args const&... args);
+format_arg::format_to_n_result format_to_n(char* out, std::size_t n, format_string<std::type_identity_t<Args>...> fmt, Args const&... args);
+#endif
 
 // impl
 
-inline std::ostream& format_str(std::ostream& out, std::string_view fmt) { return out << fmt; }
+template <typename... Args>
+std::ostream& format_str(std::ostream& out, std::string_view fmt, Args const&... args) {
+	format_to(std::ostreambuf_iterator<char>(out), fmt, args...);
+	return out;
+}
+
+template <std::size_t N, typename... Args>
+std::ostream& format_str(std::ostream& out, parsed_fmt<N> const& fmt, Args const&... args) {
+	format_to(std::ostreambuf_iterator<char>(out), fmt, args...);
+	return out;
+}
+
+template <typename Fmt, typename... Args>
+auto format_str(Fmt const& fmt, Args const&... args) -> std::enable_if_t<detail::is_runtime_fmt_v<Fmt>, std::string> {
+	std::string str;
+	format_to(std::back_inserter(str), fmt, args...);
+	return str;
+}
+
+template <std::size_t N, typename... Args>
+std::string format_str(parsed_fmt<N> const& fmt, Args const&... args) {
+	std::string str;
+	format_to(std::back_inserter(str), fmt, args...);
+	return str;
+}
+
+namespace detail {
+constexpr bool is_integer_type(char type) { return type == 'd' || type == 'x' || type == 'X' || type == 'b'; }
+constexpr bool is_float_type(char type) { return type == 'f' || type == 'e' || type == 'g'; }
+
+///
+/// \brief Write argument as std::ostream would (floating point shortest round-trip), spec applied on top
+/// Types without built-in support go through operator<<
+///
+template <typename OutputIt, typename T>
+OutputIt write_value(OutputIt out, T const& value, format_arg::spec const& spec) {
+	if constexpr (std::is_same_v<T, char const*> || std::is_same_v<T, char*>) {
+		return value ? format_arg::write_string(out, value, spec) : out;
+	} else if constexpr (std::is_convertible_v<T const&, std::string_view>) {
+		return format_arg::write_string(out, std::string_view(value), spec);
+	} else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+		if (is_integer_type(spec.type)) { return format_arg::write_integer(out, static_cast<int>(value), spec); }
+		char const c = static_cast<char>(value);
+		return format_arg::write_string(out, std::string_view(&c, 1), spec);
+	} else if constexpr (std::is_same_v<T, bool>) {
+		return format_arg::write_integer(out, static_cast<int>(value), spec);
+	} else if constexpr (std::is_integral_v<T>) {
+		if (is_float_type(spec.type)) { return format_arg::write_float(out, static_cast<double>(value), spec); }
+		return format_arg::write_integer(out, value, spec);
+	} else if constexpr (std::is_floating_point_v<T>) {
+		return format_arg::write_float(out, value, spec); // shortest round-trip by default, not ostream's 6 digits
+	} else if constexpr (std::is_pointer_v<T>) {
+		return format_arg::write_pointer(out, value, spec);
+	} else {
+		std::ostringstream str;
+		str << value;
+		return format_arg::write_string(out, str.str(), spec);
+	}
+}
+} // namespace detail
+
+template <typename OutputIt, typename Fmt, typename... Args>
+auto format_to(OutputIt out, Fmt const& fmt, Args const&... args) -> std::enable_if_t<detail::is_runtime_fmt_v<Fmt>, OutputIt> {
+	std::string_view rest(fmt);
+	bool done = false;
+	[[maybe_unused]] auto write_arg = [&](auto const& arg) {
+		if (done) { return; }
+		auto const p = format_arg::find_placeholder(rest);
+		if (p.begin == std::string_view::npos) {
+			done = true;
+			return;
+		}
+		out = detail::write_value(format_arg::write(out, rest.substr(0, p.begin)), arg, p.format);
+		rest.remove_prefix(p.end);
+	};
+	(write_arg(args), ...);
+	return format_arg::write(out, rest);
+}
+
+template <typename OutputIt, std::size_t N, typename... Args>
+OutputIt format_to(OutputIt out, parsed_fmt<N> const& fmt, Args const&... args) {
+	static_assert(sizeof...(Args) == N, "kt::format_to: argument count does not match placeholders");
+	std::size_t i = 0;
+	((out = detail::write_value(format_arg::write(out, fmt.literal(i)), args, fmt.spec(i)), ++i), ...);
+	return format_arg::write(out, fmt.literal(N));
+}
+
+template <typename Fmt, typename... Args>
+auto format_to_n(char* out, std::size_t n, Fmt const& fmt, Args const&... args)
+	-> std::enable_if_t<!(detail::literal_checked && std::is_array_v<Fmt>), format_arg::format_to_n_result> {
+	auto const it = format_to(format_arg::truncating_iterator(out, n), fmt, args...);
+	return {it.out(), it.count()};
+}
+
+#if defined(__cpp_consteval)
+template <typename... Args>
+std::string format_str(format_string<std::type_identity_t<Args>...> fmt, Args const&... args) {
+	return format_str(static_cast<parsed_fmt<sizeof...(Args)> const&>(fmt), args...);
+}
 
-template <typename Arg, typename... Args>
-std::ostream& format_str(std::ostream& out, std::string_view fmt, Arg const& arg, Args const&... args) {
-	if (auto i = fmt.find(fmt_token); i != std::string::npos) { return format_str(out << fmt.substr(0, i) << arg, fmt.substr(i + fmt_token.size()), args...); }
-	return format_str(out, fmt);
+template <typename OutputIt, typename... Args>
+OutputIt format_to(OutputIt out, format_string<std::type_identity_t<Args>...> fmt, Args const&... args) {
+	return format_to(out, static_cast<parsed_fmt<sizeof...(Args)> const&>(fmt), args...);
 }
 
 template <typename... Args>
-std::string format_str(std::string_view fmt, Args const&... args) {
-	std::stringstream str;
-	format_str(str, fmt, args...);
-	return str.str();
+format_arg::format_to_n_result format_to_n(char* out, std::size_t n, format_string<std::type_identity_t<Args>...> fmt, Args const&... args) {
+	return format_to_n(out, n, static_cast<parsed_fmt<sizeof...(Args)> const&>(fmt), args...);
 }
+#endif
 } // namespace kt
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "../bench/benchmark.h"
+
+// tokenizer benchmark inputs: tab separated records
+namespace bench {
+  // record of field_count fields with field_length bytes each, every empty_every-th field empty (0 - none)
+  inline std::string make_record(size_t field_count, size_t field_length, size_t empty_every, char delim = '\t') {
+    std::string record;
+    record.reserve(field_count * (field_length + 1));
+    for (size_t i = 0; i < field_count; ++i) {
+      if (i) record.push_back(delim);
+      if (empty_every && (i + 1) % empty_every == 0) continue;
+      for (size_t j = 0; j < field_length; ++j) {
+        record.push_back(static_cast<char>('a' + (i + j) % 26));
+      }
+    }
+    return record;
+  }
+
+  inline std::vector<input> default_corpus() {
+    std::vector<input> corpus;
+    corpus.push_back({ "message", "0\tbattery\t32ta" });
+    corpus.push_back({ "fields=4 len=8", make_record(4, 8, 0) });
+    corpus.push_back({ "fields=16 len=8", make_record(16, 8, 0) });
+    corpus.push_back({ "fields=64 len=4", make_record(64, 4, 0) });
+    corpus.push_back({ "fields=16 empty=1/2", make_record(16, 8, 2) });
+    corpus.push_back({ "fields=4 len=256", make_record(4, 256, 0) });
+    // long sparse fields: delimiter scan bound by bytes, not by delimiters
+    corpus.push_back({ "fields=8 len=4096", make_record(8, 4096, 0) });
+
+    std::string json("0\t{");
+    for (int i = 0; i < 64; ++i) {
+      if (i) json += ", ";
+      json += "\"name" + std::to_string(i) + "\": \"entry" + std::to_string(i) + "\"";
+    }
+    json += "}\ttest";
+    corpus.push_back({ "long payload", json });
+    return corpus;
+  }
+
+  // newline delimited records for bulk and multi-threaded cases
+  inline std::vector<input> bulk_corpus() {
+    std::vector<input> corpus;
+    for (size_t records : { size_t(1000), size_t(100000) }) {
+      std::string buffer;
+      const std::string record = make_record(16, 8, 0);
+      buffer.reserve(records * (record.size() + 1));
+      for (size_t i = 0; i < records; ++i) {
+        buffer.append(record).push_back('\n');
+      }
+      corpus.push_back({ "records=" + std::to_string(records), std::move(buffer) });
+    }
+    return corpus;
+  }
+}  // namespace bench
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "tokenizer_view.h"
+
+// typed decoding of delimited messages straight from the parameter string
+// numbers are parsed in place with std::from_chars, no intermediate std::string, no exceptions
+//   struct Message { int id; std::string_view element; double value; } m;
+//   auto result = decode::fields(request, '\t', m.id, m.element, m.value);
+//   if (!result.ok()) { ... check result.errors[i] of each field ... }
+namespace decode {
+  enum class field_error : std::uint8_t {
+    ok,
+    missing,       // message has fewer fields than requested
+    invalid,       // not a number / not a bool
+    out_of_range,  // number doesn't fit in target type
+    trailing,      // number followed by other characters
+  };
+
+  template <std::size_t N>
+  struct result {
+    std::array<field_error, N> errors{};
+    bool extra_fields = false;  // message has more fields than requested
+
+    bool ok() const {
+      for (auto e : errors) {
+        if (e != field_error::ok) return false;
+      }
+      return !extra_fields;
+    }
+  };
+
+  namespace detail {
+    inline field_error from_errc(std::errc ec, const char* ptr, const char* last) {
+      if (ec == std::errc::invalid_argument) return field_error::invalid;
+      if (ec == std::errc::result_out_of_range) return field_error::out_of_range;
+      return ptr == last ? field_error::ok : field_error::trailing;
+    }
+  }  // namespace detail
+
+  // single field conversion, extend with overloads for custom types
+  // on error the value is left unchanged, custom overloads should do the same
+  template <class T>
+  field_error parse(std::string_view text, T& value) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      value = text;
+      return field_error::ok;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+      value.assign(text.data(), text.size());
+      return field_error::ok;
+    } else if constexpr (std::is_same_v<T, bool>) {
+      if (text == "1" || text == "true") {
+        value = true;
+      } else if (text == "0" || text == "false") {
+        value = false;
+      } else {
+        return field_error::invalid;
+      }
+      return field_error::ok;
+    } else if constexpr (std::is_enum_v<T>) {
+      std::underlying_type_t<T> raw{};
+      const auto error = parse(text, raw);
+      if (error == field_error::ok) value = static_cast<T>(raw);
+      return error;
+    } else if constexpr (std::is_integral_v<T> || std::is_floating_point_v<T>) {
+      // from_chars writes on partial matches ("12abc"), keep value untouched unless fully parsed
+      const char* last = text.data() + text.size();
+      T parsed{};
+      auto [ptr, ec] = std::from_chars(text.data(), last, parsed);
+      const auto error = detail::from_errc(ec, ptr, last);
+      if (error == field_error::ok) value = parsed;
+      return error;
+    } else {
+      static_assert(!sizeof(T), "Unsupported field type, provide decode::parse overload");
+    }
+  }
+
+  // decodes message fields in order into given references
+  // every field is reported separately, failed fields keep their previous value
+  template <class... Ts>
+  result<sizeof...(Ts)> fields(std::string_view message, const char delim, Ts&... out) {
+    result<sizeof...(Ts)> r;
+    auto range = view::split(message, delim);
+    auto it = range.begin();
+    const auto end = range.end();
+
+    std::size_t index = 0;
+    auto next = [&](auto& value) {
+      if (it == end) {
+        r.errors[index++] = field_error::missing;
+        return;
+      }
+      r.errors[index++] = parse(*it, value);
+      ++it;
+    };
+    (next(out), ...);
+
+    r.extra_fields = it != end;
+    return r;
+  }
+
+  // same for std::tuple<Ts...>
+  template <class... Ts>
+  result<sizeof...(Ts)> fields(std::string_view message, const char delim, std::tuple<Ts...>& out) {
+    return std::apply([&](Ts&... values) { return fields(message, delim, values...); }, out);
+  }
+}  // namespace decode
@@ -11,47 +11,24 @@
 #include <cstring>
 #include <algorithm>
 
+#include "tokenizer.h"
+#include "tokenizer_view.h"
+#include "simd_scan.h"
+#include "stream_tokenizer.h"
+#include "parallel_tokenizer.h"
+#include "field_decoder.h"
+#include "token_buffer.h"
+#include "quoted_tokenizer.h"
+#include "substring_split.h"
 
-class Duration 
-{
-public:
-  Duration(std::string n) : 
-    start_time(std::chrono::high_resolution_clock::now()), name(n)
-  {
-  }
-
-  ~Duration()
-  {
-    auto now = std::chrono::high_resolution_clock::now();
-    auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time);
-    std::cout << name << ": " << milliseconds.count() << std::endl;
-  }
-protected:
-  std::string name;
-  std::chrono::high_resolution_clock::time_point start_time;
-};
+#define BENCH_COUNT_ALLOCATIONS
+#include "../bench/benchmark.h"
+#include "corpus.h"
 
 
 //////////////////////
 // utilities
 
-template <class Container> 
-void tokenizer(const std::string& str, Container* cont, const std::string& delims, bool skipEmpty) {
-  std::size_t current, previous = 0;
-
-  current = str.find_first_of(delims);
-  while (current != std::string::npos) {
-    std::string token = str.substr(previous, current - previous);
-    if (!(skipEmpty == true && token.empty())) {
-      cont->push_back(token);
-    }
-    previous = current + 1;
-    current = str.find_first_of(delims, previous);
-  }
-
-  cont->push_back(str.substr(previous, current - previous));
-}
-
 namespace messages {
   constexpr char kStringParameterDelimiter = '\t';
 }
@@ -101,7 +78,7 @@ namespace find
   }
 }
 
-namespace getline
+namespace getline_stream
 {
   void tokenize(std::string const& str, const char delim, std::vector<std::string>& out)
   {
@@ -129,32 +106,35 @@ namespace nstrtok
 
   void tokenize(std::string const& str, const char delim, std::vector<std::string>& out)
   {
-    char* token = std::strtok(const_cast<char*>(str.c_str()), &delim);
+    const char delims[] = { delim, '\0' };  // strtok expects NUL terminated delimiter set
+    char* token = std::strtok(const_cast<char*>(str.c_str()), delims);
     while (token != nullptr)
     {
       out.push_back(std::string(token));
-      token = std::strtok(nullptr, &delim);
+      token = std::strtok(nullptr, delims);
     }
   }
 
   template <class Container>
   void tokenize(std::string const& str, const char delim, Container& out)
   {
-    char* token = std::strtok(const_cast<char*>(str.c_str()), &delim);
+    const char delims[] = { delim, '\0' };  // strtok expects NUL terminated delimiter set
+    char* token = std::strtok(const_cast<char*>(str.c_str()), delims);
     for (int i = 0; token != nullptr; ++i)
     {
       out[i] = token;
-      token = std::strtok(nullptr, &delim);
+      token = std::strtok(nullptr, delims);
     }
   }
 
   void tokenize(std::string const& str, const char delim, std::string * parameter_array, const size_t parameter_array_size)
   {
-    char* token = std::strtok(const_cast<char*>(str.c_str()), &delim);
+    const char delims[] = { delim, '\0' };  // strtok expects NUL terminated delimiter set
+    char* token = std::strtok(const_cast<char*>(str.c_str()), delims);
     for (int i = 0; token != nullptr; ++i)
     {
       parameter_array[i] = token;
-      token = std::strtok(nullptr, &delim);
+      token = std::strtok(nullptr, delims);
     }
   }
 }
@@ -288,157 +268,283 @@ namespace martin
 }
 
 
-constexpr int TEST_COUNT = 10000;
+// messages use enum { ID, ELEMENT, VALUE, COUNT } layout, but corpus has inputs up to 64 fields
+// and most array variants don't check bounds
+constexpr size_t MAX_FIELDS = 64;
 
-int main()
+int main(int argc, char* argv[])
 {
-  std::string test("0\tbattery\t32ta");
-  //std::string test{ "0\t{\"name\": \"entry0\", \"string\": \"Sample\"}\ttest" };
-
-  {
-    Duration d("tokenizer");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      std::vector<std::string> parameter;
-      tokenizer(request, &parameter, "\t", false);
-    }
-  }
-
-  {
-    Duration d("SplitParameters");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      enum { ID, ELEMENT, VALUE, COUNT };
-      std::array<std::string, COUNT> parameter;
-      SplitParameters(request, parameter.data(), parameter.size());
-    }
-  }
-
-  {
-    Duration d("tokenize");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      std::vector<std::string> parameter;
-      tokenize(request, parameter);
-    }
-  }
-
-  {
-    Duration d("find");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      std::vector<std::string> parameter;
-      find::tokenize(request, messages::kStringParameterDelimiter, parameter);
-    }
-  }
-
-  {
-    Duration d("getline");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      std::vector<std::string> parameter;
-      getline::tokenize(request, messages::kStringParameterDelimiter, parameter);
-    }
-  }
-
-  {
-    Duration d("strtok");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      std::vector<std::string> parameter;
-      nstrtok::tokenize(request, &messages::kStringParameterDelimiter, parameter);
-    }
-  }
-
-  {
-    Duration d("std::strtok");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      std::vector<std::string> parameter;
-      nstrtok::tokenize(request, messages::kStringParameterDelimiter, parameter);
-    }
-  }
-
-  {
-    Duration d("strtok - array");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      enum { ID, ELEMENT, VALUE, COUNT };
-      std::array<std::string, COUNT> parameter;
-      nstrtok::tokenize(request, messages::kStringParameterDelimiter, parameter);
-    }
-  }
-
-  {
-    Duration d("strtok - string[]");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      enum { ID, ELEMENT, VALUE, COUNT };
-      std::array<std::string, COUNT> parameter;
-      nstrtok::tokenize(request, messages::kStringParameterDelimiter, parameter.data(), parameter.size());
-    }
-  }
+  // --csv or --json for machine readable output to track regressions between commits
+  const std::string output(argc > 1 ? argv[1] : "");
+
+  bench::runner r(bench::default_corpus());
+
+  r.run("tokenizer", [](const std::string& request) {
+    std::vector<std::string> parameter;
+    tokenizer(request, &parameter, "\t", false);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("tokenizer<'\\t'>", [](const std::string& request) {
+    std::vector<std::string> parameter;
+    tokenizer<'\t'>(request, &parameter, false);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("tokenizer<'\\t', ',', ';'>", [](const std::string& request) {
+    std::vector<std::string> parameter;
+    tokenizer<'\t', ',', ';'>(request, &parameter, false);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("SplitParameters", [](const std::string& request) {
+    std::array<std::string, MAX_FIELDS> parameter;
+    SplitParameters(request, parameter.data(), parameter.size());
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("tokenize", [](const std::string& request) {
+    std::vector<std::string> parameter;
+    tokenize(request, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("find", [](const std::string& request) {
+    std::vector<std::string> parameter;
+    find::tokenize(request, messages::kStringParameterDelimiter, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("getline", [](const std::string& request) {
+    std::vector<std::string> parameter;
+    getline_stream::tokenize(request, messages::kStringParameterDelimiter, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("strtok", [](const std::string& test) {
+    std::string request(test);
+    std::vector<std::string> parameter;
+    nstrtok::tokenize(request, "\t", parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("std::strtok", [](const std::string& test) {
+    std::string request(test);
+    std::vector<std::string> parameter;
+    nstrtok::tokenize(request, messages::kStringParameterDelimiter, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("strtok - array", [](const std::string& test) {
+    std::string request(test);
+    std::array<std::string, MAX_FIELDS> parameter;
+    nstrtok::tokenize(request, messages::kStringParameterDelimiter, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("strtok - string[]", [](const std::string& test) {
+    std::string request(test);
+    std::array<std::string, MAX_FIELDS> parameter;
+    nstrtok::tokenize(request, messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("strfind", [](const std::string& request) {
+    std::vector<std::string> parameter;
+    strfind::tokenize(request, messages::kStringParameterDelimiter, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("custom_strtok", [](const std::string& test) {
+    std::string request(test);
+    std::array<std::string, MAX_FIELDS> parameter;
+    custom_strtok::tokenize(request, messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("tcbrindle", [](const std::string& request) {
+    std::array<std::string, MAX_FIELDS> parameter;
+    tcbrindle::tokenize(request, messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("split", [](const std::string& request) {
+    auto v = split::split(request, "\t");
+    bench::do_not_optimize(v);
+  });
+
+  r.run("martin", [](const std::string& request) {
+    std::array<std::string, MAX_FIELDS> parameter;
+    martin::tokenize(request.c_str(), messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("view::tokenizer", [](const std::string& request) {
+    std::vector<std::string_view> parameter;
+    view::tokenizer(request, &parameter, "\t", false);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("view - vector", [](const std::string& request) {
+    std::vector<std::string_view> parameter;
+    view::tokenize(request, messages::kStringParameterDelimiter, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("view - array", [](const std::string& request) {
+    std::array<std::string_view, MAX_FIELDS> parameter;
+    view::tokenize(request, messages::kStringParameterDelimiter, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("view - string_view[]", [](const std::string& request) {
+    std::array<std::string_view, MAX_FIELDS> parameter;
+    view::tokenize(request, messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    bench::do_not_optimize(parameter);
+  });
 
   {
-    Duration d("strfind");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      std::vector<std::string> parameter;
-      strfind::tokenize(request, messages::kStringParameterDelimiter, parameter);
-    }
-  }
-
-  {
-    Duration d("custom_strtok");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      enum { ID, ELEMENT, VALUE, COUNT };
-      std::array<std::string, COUNT> parameter;
-      custom_strtok::tokenize(request, messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    // one buffer for the whole stream of messages
+    token_buffer tokens;
+    r.run("token_buffer", [&tokens](const std::string& test) {
+      tokens.tokenize(test, messages::kStringParameterDelimiter);
+      bench::do_not_optimize(tokens);
+    });
+  }
+
+  r.run("view::split", [](const std::string& request) {
+    std::array<std::string_view, MAX_FIELDS> parameter;
+    size_t count = 0;
+    for (std::string_view token : view::split(request, messages::kStringParameterDelimiter)) {
+      parameter[count++] = token;
     }
-  }
-
-  {
-    Duration d("tcbrindle");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      enum { ID, ELEMENT, VALUE, COUNT };
-      std::array<std::string, COUNT> parameter;
-      tcbrindle::tokenize(request, messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("simd - vector", [](const std::string& request) {
+    std::vector<std::string_view> parameter;
+    simd::tokenize(request, messages::kStringParameterDelimiter, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("simd - string_view[]", [](const std::string& request) {
+    std::array<std::string_view, MAX_FIELDS> parameter;
+    simd::tokenize(request, messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("stream - chunked", [](const std::string& test) {
+    // small chunks to exercise records crossing chunk boundary
+    size_t fields = 0;
+    stream::chunked_tokenizer tokenizer(
+      [](const std::string_view*, size_t count, void* data) { *static_cast<size_t*>(data) += count; },
+      &fields, messages::kStringParameterDelimiter);
+    constexpr size_t CHUNK_SIZE = 8;
+    for (size_t pos = 0; pos < test.size(); pos += CHUNK_SIZE) {
+      tokenizer.feed(test.data() + pos, std::min(CHUNK_SIZE, test.size() - pos));
     }
-  }
-
-  {
-    Duration d("split");
-    
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      auto v = split::split(request, "\t");
+    tokenizer.finish();
+    bench::do_not_optimize(fields);
+  });
+
+  // delimiters inside quotes and escaped quotes belong to the field
+  std::vector<bench::input> quoted_corpus = bench::default_corpus();
+  quoted_corpus.push_back({ "quoted", "0\t\"battery\tlevel\"\t{\"text\": \"a\\\"\tb\"}\t32ta" });
+
+  r.run("quoted - vector", quoted_corpus, [](const std::string& test) {
+    std::vector<std::string_view> parameter;
+    quoted::tokenize(test, messages::kStringParameterDelimiter, parameter);
+    bench::do_not_optimize(parameter);
+  });
+
+  r.run("quoted - string_view[]", quoted_corpus, [](const std::string& test) {
+    std::array<std::string_view, MAX_FIELDS> parameter;
+    quoted::tokenize(test, messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    bench::do_not_optimize(parameter);
+  });
+
+  // multi-byte delimiters
+  for (const char* delim : { "\r\n", "||" }) {
+    const std::string suffix = std::string(" - ") + (delim[0] == '\r' ? "\\r\\n" : delim);
+    std::vector<bench::input> multi_corpus;
+    for (size_t fields : { size_t(4), size_t(64) }) {
+      std::string record;
+      for (size_t i = 0; i < fields; ++i) {
+        if (i) record += delim;
+        record += bench::make_record(1, 8 + i % 8, 0);
+      }
+      multi_corpus.push_back({ "fields=" + std::to_string(fields), record });
     }
-  }
-
-  {
-    Duration d("martin");
-
-    for (int i = 0; i < TEST_COUNT; ++i) {
-      std::string request(test);
-      enum { ID, ELEMENT, VALUE, COUNT };
-      std::array<std::string, COUNT> parameter;
-      martin::tokenize(request.c_str(), messages::kStringParameterDelimiter, parameter.data(), parameter.size());
+    // single '|' is a first byte candidate only, not a match
+    multi_corpus.push_back({ "no match len=1024", bench::make_record(4, 256, 0, '|') });
+    // degenerate: first byte every 4 bytes, never a match ("abc|abc|" on "||")
+    std::string first_only;
+    for (size_t i = 0; i < 256; ++i) {
+      first_only.append("abc").push_back(delim[0]);
     }
+    multi_corpus.push_back({ "first byte only len=1024", first_only });
+
+    r.run("split" + suffix, multi_corpus, [delim](const std::string& test) {
+      auto v = split::split(test, delim);
+      bench::do_not_optimize(v);
+    });
+
+    r.run("substring::split" + suffix, multi_corpus, [delim](const std::string& test) {
+      auto v = substring::split(test, delim);
+      bench::do_not_optimize(v);
+    });
+  }
+
+  // typed messages: split to strings and convert again against direct decoding
+  const std::vector<bench::input> typed = { { "typed message", "42\tbattery\t3.7" } };
+
+  r.run("SplitParameters + stoi/stod", typed, [](const std::string& test) {
+    enum { ID, ELEMENT, VALUE, COUNT };
+    std::array<std::string, COUNT> parameter;
+    SplitParameters(test, parameter.data(), parameter.size());
+    int id = std::stoi(parameter[ID]);
+    double value = std::stod(parameter[VALUE]);
+    bench::do_not_optimize(id);
+    bench::do_not_optimize(parameter[ELEMENT]);
+    bench::do_not_optimize(value);
+  });
+
+  r.run("decode::fields", typed, [](const std::string& test) {
+    struct { int id; std::string_view element; double value; } message;
+    auto result = decode::fields(test, messages::kStringParameterDelimiter, message.id, message.element, message.value);
+    bench::do_not_optimize(result);
+    bench::do_not_optimize(message);
+  });
+
+  // bulk record buffers, single thread baseline against all cores
+  // powers of two below core count, then all cores (also when that is 6, 12, ...)
+  const auto bulk = bench::bulk_corpus();
+  std::vector<size_t> thread_counts;
+  for (size_t threads = 1; threads < parallel::default_thread_count(); threads *= 2) {
+    thread_counts.push_back(threads);
+  }
+  thread_counts.push_back(parallel::default_thread_count());
+  for (size_t threads : thread_counts) {
+    const std::string suffix = " threads=" + std::to_string(threads);
+
+    r.run("parallel::for_each_record" + suffix, bulk, [threads](const std::string& test) {
+      std::vector<size_t> fields(threads);
+      parallel::for_each_record(test, [&](size_t index, const std::string_view*, size_t count) { fields[index] += count; }, threads);
+      bench::do_not_optimize(fields);
+    });
+
+    r.run("parallel::tokenize" + suffix, bulk, [threads](const std::string& test) {
+      auto parameter = parallel::tokenize(test, threads);
+      bench::do_not_optimize(parameter);
+    });
+  }
+
+  if (output == "--csv") {
+    r.print_csv(std::cout);
+  } else if (output == "--json") {
+    r.print_json(std::cout);
+  } else {
+    r.print_table(std::cout);
   }
-
 }
 
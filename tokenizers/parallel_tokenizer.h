@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "simd_scan.h"
+
+// multi-threaded tokenization of newline delimited record buffers
+// buffer is cut at record boundaries into one range per thread, every range is tokenized
+// independently with simd::scan, no synchronization between threads while tokenizing
+namespace parallel {
+  inline size_t default_thread_count() {
+    const size_t count = std::thread::hardware_concurrency();
+    return count ? count : 1;
+  }
+
+  // cuts buffer into at most parts ranges, each range ends right after a record delimiter (except the last one)
+  inline std::vector<std::string_view> partition(std::string_view buffer, size_t parts, const char record_delim = '\n') {
+    std::vector<std::string_view> ranges;
+    if (parts == 0) parts = 1;
+    ranges.reserve(parts);
+
+    size_t start = 0;
+    for (size_t i = 1; i < parts && start < buffer.size(); ++i) {
+      size_t cut = std::max(start, buffer.size() * i / parts);
+      cut = buffer.find(record_delim, cut);
+      if (cut == std::string_view::npos) break;
+      ranges.push_back(buffer.substr(start, cut + 1 - start));
+      start = cut + 1;
+    }
+    if (start < buffer.size()) ranges.push_back(buffer.substr(start));
+    return ranges;
+  }
+
+  // calls consumer(fields, count) for every record in range, fields vector is reused
+  template <class Consumer>
+  void tokenize_range(std::string_view range, Consumer& consumer, std::vector<std::string_view>& fields,
+                      const char field_delim, const char record_delim) {
+    size_t start = 0;
+    auto emit = [&](std::string_view record) {
+      fields.clear();
+      simd::tokenize(record, field_delim, fields);
+      consumer(static_cast<const std::string_view*>(fields.data()), fields.size());
+    };
+    simd::scan(range, record_delim, [&](size_t pos) {
+      emit(range.substr(start, pos - start));
+      start = pos + 1;
+      return true;
+    });
+    if (start < range.size()) emit(range.substr(start));
+  }
+
+  // hands records of each range to consumer(thread_index, fields, count) on that range's thread
+  // records of one thread arrive in buffer order, threads run concurrently
+  template <class Consumer>
+  void for_each_record(std::string_view buffer, Consumer&& consumer, size_t thread_count = default_thread_count(),
+                       const char field_delim = '\t', const char record_delim = '\n') {
+    const auto ranges = partition(buffer, thread_count, record_delim);
+
+    auto work = [&](size_t index) {
+      std::vector<std::string_view> fields;
+      auto per_thread = [&](const std::string_view* f, size_t count) { consumer(index, f, count); };
+      tokenize_range(ranges[index], per_thread, fields, field_delim, record_delim);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(ranges.size());
+    for (size_t i = 1; i < ranges.size(); ++i) {
+      threads.emplace_back(work, i);
+    }
+    if (!ranges.empty()) work(0);  // calling thread takes the first range
+    for (auto& t : threads) t.join();
+  }
+
+  // all fields of all records in buffer order
+  // fields of record i are fields[records[i] .. records[i + 1]), records has one extra end entry
+  struct tokenized {
+    std::vector<std::string_view> fields;
+    std::vector<size_t> records;
+  };
+
+  // tokenizes ranges in parallel, then every thread copies its fields into merged output
+  // at offset given by prefix sum of field counts
+  inline tokenized tokenize(std::string_view buffer, size_t thread_count = default_thread_count(),
+                            const char field_delim = '\t', const char record_delim = '\n') {
+    const auto ranges = partition(buffer, thread_count, record_delim);
+    std::vector<tokenized> parts(ranges.size());
+
+    auto run = [&](auto&& task) {
+      std::vector<std::thread> threads;
+      threads.reserve(ranges.size());
+      for (size_t i = 1; i < ranges.size(); ++i) {
+        threads.emplace_back(task, i);
+      }
+      if (!ranges.empty()) task(0);
+      for (auto& t : threads) t.join();
+    };
+
+    run([&](size_t index) {
+      auto& part = parts[index];
+      std::vector<std::string_view> fields;
+      auto collect = [&](const std::string_view* f, size_t count) {
+        part.records.push_back(part.fields.size());
+        part.fields.insert(part.fields.end(), f, f + count);
+      };
+      tokenize_range(ranges[index], collect, fields, field_delim, record_delim);
+    });
+
+    std::vector<size_t> field_offset(parts.size() + 1, 0);
+    std::vector<size_t> record_offset(parts.size() + 1, 0);
+    for (size_t i = 0; i < parts.size(); ++i) {
+      field_offset[i + 1] = field_offset[i] + parts[i].fields.size();
+      record_offset[i + 1] = record_offset[i] + parts[i].records.size();
+    }
+
+    tokenized result;
+    result.fields.resize(field_offset.back());
+    result.records.resize(record_offset.back() + 1);
+    result.records.back() = field_offset.back();
+
+    run([&](size_t index) {
+      const auto& part = parts[index];
+      std::copy(part.fields.begin(), part.fields.end(), result.fields.begin() + field_offset[index]);
+      std::transform(part.records.begin(), part.records.end(), result.records.begin() + record_offset[index],
+        [&](size_t first) { return first + field_offset[index]; });
+    });
+    return result;
+  }
+}  // namespace parallel
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "simd_scan.h"
+
+// quote and escape aware splitter
+// input is classified 64 bytes at a time into quote, backslash and delimiter bitmasks,
+// escaped characters are found with carry propagation, quoted regions with prefix XOR,
+// delimiter bits outside quotes are the real field boundaries - no per byte state machine
+// tokens keep their quotes and escapes, unescaping is up to the caller
+namespace quoted {
+  namespace detail {
+    struct block_masks {
+      std::uint64_t quote;
+      std::uint64_t backslash;
+      std::uint64_t delim;
+    };
+
+    inline unsigned ctz64(std::uint64_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+      unsigned long index;
+      _BitScanForward64(&index, mask);
+      return index;
+#elif defined(_MSC_VER) && !defined(__clang__)
+      unsigned long index;
+      if (_BitScanForward(&index, static_cast<std::uint32_t>(mask))) return index;
+      _BitScanForward(&index, static_cast<std::uint32_t>(mask >> 32));
+      return index + 32;
+#else
+      return __builtin_ctzll(mask);
+#endif
+    }
+
+    // bit i set when bit count of mask[0..i] is odd, i.e. byte i is between opening and closing quote
+    inline std::uint64_t prefix_xor(std::uint64_t mask) {
+      mask ^= mask << 1;
+      mask ^= mask << 2;
+      mask ^= mask << 4;
+      mask ^= mask << 8;
+      mask ^= mask << 16;
+      mask ^= mask << 32;
+      return mask;
+    }
+
+    // classifies exactly 64 bytes
+    inline block_masks classify(const char* block, char quote, char escape, char delim) {
+#if defined(SIMD_SCAN_X86)
+      const __m128i q = _mm_set1_epi8(quote);
+      const __m128i e = _mm_set1_epi8(escape);
+      const __m128i d = _mm_set1_epi8(delim);
+      block_masks masks{ 0, 0, 0 };
+      for (int i = 0; i < 4; ++i) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+        masks.quote |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, q)))) << (16 * i);
+        masks.backslash |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, e)))) << (16 * i);
+        masks.delim |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, d)))) << (16 * i);
+      }
+      return masks;
+#else
+      block_masks masks{ 0, 0, 0 };
+      for (int i = 0; i < 64; ++i) {
+        const std::uint64_t bit = std::uint64_t(1) << i;
+        masks.quote |= block[i] == quote ? bit : 0;
+        masks.backslash |= block[i] == escape ? bit : 0;
+        masks.delim |= block[i] == delim ? bit : 0;
+      }
+      return masks;
+#endif
+    }
+
+    // state carried from one 64 byte block to the next
+    class scanner {
+    public:
+      // bits of delimiters that separate fields
+      std::uint64_t next(const block_masks& masks) {
+        const std::uint64_t escaped = find_escaped(masks.backslash);
+        const std::uint64_t quotes = masks.quote & ~escaped;
+        const std::uint64_t in_quotes = prefix_xor(quotes) ^ prev_in_quotes_;
+        prev_in_quotes_ = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_quotes) >> 63);
+        return masks.delim & ~in_quotes & ~escaped;
+      }
+
+    private:
+      // characters preceded by odd number of backslashes (simdjson approach)
+      std::uint64_t find_escaped(std::uint64_t backslash) {
+        constexpr std::uint64_t even_bits = 0x5555555555555555ULL;
+        backslash &= ~prev_escaped_;
+        const std::uint64_t follows_escape = backslash << 1 | prev_escaped_;
+        const std::uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+        const std::uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+        prev_escaped_ = sequences_starting_on_even_bits < backslash ? 1 : 0;  // carry out of bit 63
+        const std::uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+        return (even_bits ^ invert_mask) & follows_escape;
+      }
+
+      std::uint64_t prev_escaped_ = 0;
+      std::uint64_t prev_in_quotes_ = 0;
+    };
+  }  // namespace detail
+
+  // calls on_delim(offset) for every delimiter outside quotes and not escaped
+  // on_delim returns false to stop
+  template <class F>
+  void scan(std::string_view str, const char delim, F&& on_delim, const char quote = '"', const char escape = '\\') {
+    detail::scanner scanner;
+    const char* data = str.data();
+    const std::size_t size = str.size();
+
+    auto emit = [&](std::uint64_t mask, std::size_t base) {
+      while (mask) {
+        if (!on_delim(base + detail::ctz64(mask))) return false;
+        mask &= mask - 1;
+      }
+      return true;
+    };
+
+    std::size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+      if (!emit(scanner.next(detail::classify(data + i, quote, escape, delim)), i)) return;
+    }
+    if (i < size) {
+      // zero padded tail, padding bits are masked out
+      char tail[64] = {};
+      std::memcpy(tail, data + i, size - i);
+      const std::uint64_t valid = (std::uint64_t(1) << (size - i)) - 1;
+      emit(scanner.next(detail::classify(tail, quote, escape, delim)) & valid, i);
+    }
+  }
+
+  inline void tokenize(std::string_view str, const char delim, std::vector<std::string_view>& out,
+                       const char quote = '"', const char escape = '\\') {
+    std::size_t pos_start = 0;
+    scan(str, delim, [&](std::size_t pos) {
+      out.push_back(str.substr(pos_start, pos - pos_start));
+      pos_start = pos + 1;
+      return true;
+    }, quote, escape);
+    out.push_back(str.substr(pos_start));
+  }
+
+  // same semantics as SplitParameters - last slot receives the rest of the string
+  inline std::size_t tokenize(std::string_view str, const char delim, std::string_view* parameter_array, const std::size_t parameter_array_size,
+                              const char quote = '"', const char escape = '\\') {
+    if (parameter_array_size == 0) return 0;
+
+    std::size_t found_strings = 0;
+    std::size_t pos_start = 0;
+    if (parameter_array_size > 1) {
+      scan(str, delim, [&](std::size_t pos) {
+        parameter_array[found_strings++] = str.substr(pos_start, pos - pos_start);
+        pos_start = pos + 1;
+        return found_strings + 1 < parameter_array_size;
+      }, quote, escape);
+    }
+    parameter_array[found_strings++] = str.substr(pos_start);
+    return found_strings;
+  }
+}  // namespace quoted
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// vectorized delimiter scanner - classifies 16 (SSE2) or 32 (AVX2) bytes per step
+// into a delimiter bitmask and reports every delimiter offset in one pass
+// AVX2 is selected at runtime, SSE2 is the x86-64 baseline, other targets use memchr
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SIMD_SCAN_X86) && !defined(_MSC_VER)
+// GCC/Clang need the target attribute to emit AVX2 without global -mavx2
+#define SIMD_SCAN_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_SCAN_AVX2
+#endif
+
+namespace simd {
+  namespace detail {
+    inline unsigned ctz(std::uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return index;
+#else
+      return __builtin_ctz(mask);
+#endif
+    }
+
+    // calls on_delim(offset) for every bit set, stops when on_delim returns false
+    template <class F>
+    bool emit(std::uint32_t mask, std::size_t base, F& on_delim) {
+      while (mask) {
+        if (!on_delim(base + ctz(mask))) return false;
+        mask &= mask - 1;
+      }
+      return true;
+    }
+
+    template <class F>
+    void scan_scalar(const char* data, std::size_t i, std::size_t size, char delim, F& on_delim) {
+      while (i < size) {
+        auto found = static_cast<const char*>(std::memchr(data + i, delim, size - i));
+        if (found == nullptr) return;
+        i = found - data;
+        if (!on_delim(i++)) return;
+      }
+    }
+
+#if defined(SIMD_SCAN_X86)
+    inline bool has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+      int info[4];
+      __cpuid(info, 0);
+      if (info[0] < 7) return false;
+      __cpuidex(info, 7, 0);
+      const bool avx2 = (info[1] & (1 << 5)) != 0;
+      __cpuid(info, 1);
+      const bool osxsave = (info[2] & (1 << 27)) != 0;
+      return avx2 && osxsave && ((_xgetbv(0) & 6) == 6);
+#else
+      return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    // group of 4 blocks without delimiter at i: hands the rest of the run to memchr (libc's unrolled, aligned scan)
+    // and emits the delimiter ending it, i continues past that delimiter or at size
+    template <class F>
+    bool skip_run(const char* data, std::size_t& i, std::size_t group, std::size_t size, char delim, F& on_delim) {
+      auto found = static_cast<const char*>(std::memchr(data + i + group, delim, size - i - group));
+      if (found == nullptr) {
+        i = size;
+        return true;
+      }
+      i = found - data;
+      return on_delim(i++);
+    }
+
+    // unrolled by 4 blocks with OR-ed compare masks: one test per 64 (SSE2) or 128 (AVX2) bytes,
+    // dense delimiters are emitted block by block, long sparse fields go to memchr
+    template <class F>
+    void scan_sse2(const char* data, std::size_t size, char delim, F& on_delim) {
+      const __m128i needle = _mm_set1_epi8(delim);
+      const auto compare = [&](std::size_t offset) {
+        return _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset)), needle);
+      };
+      std::size_t i = 0;
+      while (i + 64 <= size) {
+        const __m128i eq0 = compare(i), eq1 = compare(i + 16), eq2 = compare(i + 32), eq3 = compare(i + 48);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3))) == 0) {
+          if (!skip_run(data, i, 64, size, delim, on_delim)) return;
+          continue;
+        }
+        const auto low = static_cast<std::uint32_t>(_mm_movemask_epi8(eq0)) | static_cast<std::uint32_t>(_mm_movemask_epi8(eq1)) << 16;
+        const auto high = static_cast<std::uint32_t>(_mm_movemask_epi8(eq2)) | static_cast<std::uint32_t>(_mm_movemask_epi8(eq3)) << 16;
+        if (!emit(low, i, on_delim) || !emit(high, i + 32, on_delim)) return;
+        i += 64;
+      }
+      for (; i + 16 <= size; i += 16) {
+        const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(compare(i)));
+        if (!emit(mask, i, on_delim)) return;
+      }
+      scan_scalar(data, i, size, delim, on_delim);
+    }
+
+    // same as scan_sse2, no lambda since GCC doesn't apply the target attribute to it
+    template <class F>
+    SIMD_SCAN_AVX2 void scan_avx2(const char* data, std::size_t size, char delim, F& on_delim) {
+      const __m256i needle = _mm256_set1_epi8(delim);
+      std::size_t i = 0;
+      while (i + 128 <= size) {
+        const auto* block = reinterpret_cast<const __m256i*>(data + i);
+        const __m256i eq0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block), needle);
+        const __m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block + 1), needle);
+        const __m256i eq2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block + 2), needle);
+        const __m256i eq3 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block + 3), needle);
+        const __m256i any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+        if (_mm256_testz_si256(any, any)) {
+          if (!skip_run(data, i, 128, size, delim, on_delim)) return;
+          continue;
+        }
+        if (!emit(static_cast<std::uint32_t>(_mm256_movemask_epi8(eq0)), i, on_delim) ||
+            !emit(static_cast<std::uint32_t>(_mm256_movemask_epi8(eq1)), i + 32, on_delim) ||
+            !emit(static_cast<std::uint32_t>(_mm256_movemask_epi8(eq2)), i + 64, on_delim) ||
+            !emit(static_cast<std::uint32_t>(_mm256_movemask_epi8(eq3)), i + 96, on_delim)) return;
+        i += 128;
+      }
+      for (; i + 32 <= size; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        if (!emit(mask, i, on_delim)) return;
+      }
+      scan_scalar(data, i, size, delim, on_delim);
+    }
+#endif
+  }  // namespace detail
+
+  // invokes on_delim(offset) for each delimiter in ascending order
+  // on_delim returns false to stop the scan
+  template <class F>
+  void scan(std::string_view str, const char delim, F&& on_delim) {
+#if defined(SIMD_SCAN_X86)
+    static const bool avx2 = detail::has_avx2();
+    if (avx2) {
+      detail::scan_avx2(str.data(), str.size(), delim, on_delim);
+    } else {
+      detail::scan_sse2(str.data(), str.size(), delim, on_delim);
+    }
+#else
+    detail::scan_scalar(str.data(), 0, str.size(), delim, on_delim);
+#endif
+  }
+
+  // stores up to capacity delimiter offsets, returns number stored
+  inline std::size_t find_all(std::string_view str, const char delim, std::uint32_t* offsets, const std::size_t capacity) {
+    std::size_t count = 0;
+    if (capacity == 0) return 0;
+    scan(str, delim, [&](std::size_t pos) {
+      offsets[count++] = static_cast<std::uint32_t>(pos);
+      return count < capacity;
+    });
+    return count;
+  }
+
+  // same semantics as SplitParameters - last slot receives the rest of the string
+  inline std::size_t tokenize(std::string_view str, const char delim, std::string_view* parameter_array, const std::size_t parameter_array_size) {
+    if (parameter_array_size == 0) return 0;
+
+    std::size_t found_strings = 0;
+    std::size_t pos_start = 0;
+    if (parameter_array_size > 1) {
+      scan(str, delim, [&](std::size_t pos) {
+        parameter_array[found_strings++] = str.substr(pos_start, pos - pos_start);
+        pos_start = pos + 1;
+        return found_strings + 1 < parameter_array_size;
+      });
+    }
+    parameter_array[found_strings++] = str.substr(pos_start);
+    return found_strings;
+  }
+
+  inline void tokenize(std::string_view str, const char delim, std::vector<std::string_view>& out) {
+    std::size_t pos_start = 0;
+    scan(str, delim, [&](std::size_t pos) {
+      out.push_back(str.substr(pos_start, pos - pos_start));
+      pos_start = pos + 1;
+      return true;
+    });
+    out.push_back(str.substr(pos_start));
+  }
+}  // namespace simd
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "simd_scan.h"
+
+// streaming tokenizer for inputs bigger than memory
+// input is fed chunk by chunk, records are split on record delimiter and fields on field delimiter
+// only a record crossing a chunk boundary is copied, so memory use is bounded by chunk size + longest record
+namespace stream {
+  // receives fields of one record, same shape as martin::split_fn
+  typedef void(*record_fn)(const std::string_view* fields, size_t count, void* data);
+
+  class chunked_tokenizer {
+  public:
+    chunked_tokenizer(record_fn fun, void* data, char field_delim = '\t', char record_delim = '\n')
+      : fun_(fun), data_(data), field_delim_(field_delim), record_delim_(record_delim) {
+    }
+
+    // emits every record completed by this chunk, keeps the unfinished tail
+    void feed(const char* chunk, size_t size) {
+      std::string_view input(chunk, size);
+      size_t start = 0;
+      simd::scan(input, record_delim_, [&](size_t pos) {
+        if (partial_.empty()) {
+          emit(input.substr(start, pos - start));
+        } else {
+          partial_.append(chunk + start, pos - start);
+          emit(partial_);
+          partial_.clear();  // keeps capacity for the next boundary
+        }
+        start = pos + 1;
+        return true;
+      });
+      partial_.append(chunk + start, size - start);
+    }
+
+    // emits the last record if input does not end with record delimiter
+    void finish() {
+      if (!partial_.empty()) {
+        emit(partial_);
+        partial_.clear();
+      }
+    }
+
+  private:
+    void emit(std::string_view record) {
+      fields_.clear();
+      simd::tokenize(record, field_delim_, fields_);
+      fun_(fields_.data(), fields_.size(), data_);
+    }
+
+    record_fn fun_;
+    void* data_;
+    char field_delim_;
+    char record_delim_;
+    std::string partial_;                   // record carried across chunk boundary
+    std::vector<std::string_view> fields_;  // reused between records
+  };
+
+#if !defined(_WIN32)
+  // reads fd in fixed-size chunks until EOF, returns false on read error (see errno)
+  inline bool tokenize_fd(int fd, chunked_tokenizer& tokenizer, size_t chunk_size = 1 << 16) {
+    std::vector<char> buffer(chunk_size);
+    for (;;) {
+      ssize_t count = ::read(fd, buffer.data(), buffer.size());
+      if (count < 0) {
+        if (errno == EINTR) continue;
+        return false;
+      }
+      if (count == 0) break;
+      tokenizer.feed(buffer.data(), static_cast<size_t>(count));
+    }
+    tokenizer.finish();
+    return true;
+  }
+
+  // maps file read-only and feeds it chunk by chunk
+  // consumed pages are released, so resident memory stays at about one chunk
+  inline bool tokenize_mmap(const char* path, chunked_tokenizer& tokenizer, size_t chunk_size = 1 << 20) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0) {
+      ::close(fd);
+      tokenizer.finish();
+      return true;
+    }
+
+    void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+    ::madvise(map, size, MADV_SEQUENTIAL);
+
+    // keep chunks page aligned so released ranges never cover unread bytes
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    chunk_size = (chunk_size + page - 1) / page * page;
+
+    const char* base = static_cast<const char*>(map);
+    for (size_t offset = 0; offset < size; offset += chunk_size) {
+      const size_t count = size - offset < chunk_size ? size - offset : chunk_size;
+      tokenizer.feed(base + offset, count);
+      ::madvise(const_cast<char*>(base) + offset, count, MADV_DONTNEED);
+    }
+    tokenizer.finish();
+
+    ::munmap(map, size);
+    return true;
+  }
+#endif
+}  // namespace stream
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "simd_scan.h"
+
+// splitting on multi-byte delimiter such as "\r\n" or "||"
+// candidates are filtered by comparing first and last delimiter byte 16/32 positions at once,
+// only positions where both match are verified with memcmp, runs without first byte are left to memchr
+namespace substring {
+  namespace detail {
+    // calls on_match(pos) for matches starting in [i, size - k]
+    template <class F>
+    void scan_scalar(const char* data, std::size_t i, std::size_t size, std::string_view delim, F& on_match) {
+      const std::size_t k = delim.size();
+      while (i + k <= size) {
+        auto found = static_cast<const char*>(std::memchr(data + i, delim[0], size - k + 1 - i));
+        if (found == nullptr) break;
+        i = found - data;
+        if (std::memcmp(data + i + 1, delim.data() + 1, k - 1) == 0) {
+          if (!on_match(i)) return;
+          i += k;
+        } else {
+          ++i;
+        }
+      }
+    }
+
+#if defined(SIMD_SCAN_X86)
+    // skip is first position allowed for next match, keeps matches non-overlapping ("aaa" on "aa")
+    // not inlined with the callback, so callers skip it for an empty mask
+    template <class F>
+    bool verify(std::uint32_t mask, std::size_t base, const char* data, std::string_view delim, std::size_t& skip, F& on_match) {
+      while (mask) {
+        const std::size_t pos = base + simd::detail::ctz(mask);
+        mask &= mask - 1;
+        if (pos < skip) continue;
+        // two byte delimiter ("\r\n", "||") is already matched by first and last byte
+        if (delim.size() == 2 || std::memcmp(data + pos + 1, delim.data() + 1, delim.size() - 2) == 0) {
+          if (!on_match(pos)) return false;
+          skip = pos + delim.size();
+        }
+      }
+      return true;
+    }
+
+    // sparse run after group of blocks at i: candidates are found by memchr and checked one by one,
+    // a candidate closer than one group to the previous one goes back to the vector loop at i
+    template <class F>
+    bool scan_sparse(const char* data, std::size_t& i, std::size_t group, std::size_t size, std::string_view delim, std::size_t& skip, F& on_match) {
+      const std::size_t k = delim.size();
+      std::size_t from = i + group > skip ? i + group : skip;
+      while (from + k <= size) {
+        auto found = static_cast<const char*>(std::memchr(data + from, delim[0], size - k + 1 - from));
+        if (found == nullptr) break;
+        const std::size_t pos = found - data;
+        if (pos - from < group) {
+          i = pos;
+          return true;
+        }
+        if (data[pos + k - 1] == delim.back() && !verify(1, pos, data, delim, skip, on_match)) return false;
+        from = pos + 1 > skip ? pos + 1 : skip;
+      }
+      i = size;
+      return true;
+    }
+
+    // unrolled by 4 blocks, first byte masks are OR-ed: a group without candidate costs one test,
+    // last byte is compared only in groups with a candidate
+    // dense candidates ("abc|abc|" on "||") stay in the vector loop, sparse ones are left to memchr
+    template <class F>
+    void scan_sse2(const char* data, std::size_t size, std::string_view delim, F& on_match) {
+      const std::size_t k = delim.size();
+      const __m128i first = _mm_set1_epi8(delim.front());
+      const __m128i last = _mm_set1_epi8(delim.back());
+      const auto compare = [&](std::size_t offset, __m128i needle) {
+        return _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset)), needle);
+      };
+      const auto candidates = [&](std::size_t offset, __m128i eq_first) {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_and_si128(eq_first, compare(offset + k - 1, last))));
+      };
+      std::size_t i = 0;
+      std::size_t skip = 0;
+      while (i + k - 1 + 64 <= size) {
+        const __m128i eq0 = compare(i, first), eq1 = compare(i + 16, first), eq2 = compare(i + 32, first), eq3 = compare(i + 48, first);
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3))) != 0) {
+          const auto low = candidates(i, eq0) | candidates(i + 16, eq1) << 16;
+          const auto high = candidates(i + 32, eq2) | candidates(i + 48, eq3) << 16;
+          if ((low && !verify(low, i, data, delim, skip, on_match)) || (high && !verify(high, i + 32, data, delim, skip, on_match))) return;
+        }
+        if (_mm_movemask_epi8(eq3) == 0) {
+          if (!scan_sparse(data, i, 64, size, delim, skip, on_match)) return;
+        } else {
+          i += 64;
+        }
+      }
+      for (; i + k - 1 + 16 <= size; i += 16) {
+        const auto mask = candidates(i, compare(i, first));
+        if (mask && !verify(mask, i, data, delim, skip, on_match)) return;
+      }
+      scan_scalar(data, i > skip ? i : skip, size, delim, on_match);
+    }
+
+    // same as scan_sse2, no lambda since GCC doesn't apply the target attribute to it
+    template <class F>
+    SIMD_SCAN_AVX2 void scan_avx2(const char* data, std::size_t size, std::string_view delim, F& on_match) {
+      const std::size_t k = delim.size();
+      const __m256i first = _mm256_set1_epi8(delim.front());
+      const __m256i last = _mm256_set1_epi8(delim.back());
+      std::size_t i = 0;
+      std::size_t skip = 0;
+      while (i + k - 1 + 128 <= size) {
+        const auto* block = reinterpret_cast<const __m256i*>(data + i);
+        const __m256i eq0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block), first);
+        const __m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block + 1), first);
+        const __m256i eq2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block + 2), first);
+        const __m256i eq3 = _mm256_cmpeq_epi8(_mm256_loadu_si256(block + 3), first);
+        const __m256i any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+        if (!_mm256_testz_si256(any, any)) {
+          const auto* block_last = reinterpret_cast<const __m256i*>(data + i + k - 1);
+          const __m256i eq[4] = { eq0, eq1, eq2, eq3 };
+          for (std::size_t b = 0; b < 4; ++b) {
+            const __m256i match = _mm256_and_si256(eq[b], _mm256_cmpeq_epi8(_mm256_loadu_si256(block_last + b), last));
+            const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(match));
+            if (mask && !verify(mask, i + 32 * b, data, delim, skip, on_match)) return;
+          }
+        }
+        if (_mm256_testz_si256(eq3, eq3)) {
+          if (!scan_sparse(data, i, 128, size, delim, skip, on_match)) return;
+        } else {
+          i += 128;
+        }
+      }
+      for (; i + k - 1 + 32 <= size; i += 32) {
+        const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + k - 1));
+        const __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+        if (mask && !verify(mask, i, data, delim, skip, on_match)) return;
+      }
+      scan_scalar(data, i > skip ? i : skip, size, delim, on_match);
+    }
+#endif
+  }  // namespace detail
+
+  // invokes on_match(offset) for each non-overlapping occurrence of delim, left to right
+  // on_match returns false to stop the scan
+  template <class F>
+  void scan(std::string_view str, std::string_view delim, F&& on_match) {
+    if (delim.empty() || delim.size() > str.size()) return;
+    if (delim.size() == 1) {
+      simd::scan(str, delim[0], on_match);
+      return;
+    }
+#if defined(SIMD_SCAN_X86)
+    static const bool avx2 = simd::detail::has_avx2();
+    if (avx2) {
+      detail::scan_avx2(str.data(), str.size(), delim, on_match);
+    } else {
+      detail::scan_sse2(str.data(), str.size(), delim, on_match);
+    }
+#else
+    detail::scan_scalar(str.data(), 0, str.size(), delim, on_match);
+#endif
+  }
+
+  // same semantics as split::split - empty tokens are skipped
+  inline void split(std::string_view str, std::string_view delim, std::vector<std::string_view>& tokens) {
+    std::size_t prev = 0;
+    scan(str, delim, [&](std::size_t pos) {
+      if (pos != prev) tokens.push_back(str.substr(prev, pos - prev));
+      prev = pos + delim.size();
+      return true;
+    });
+    if (prev < str.size()) tokens.push_back(str.substr(prev));
+  }
+
+  inline std::vector<std::string_view> split(std::string_view str, std::string_view delim) {
+    std::vector<std::string_view> tokens;
+    split(str, delim, tokens);
+    return tokens;
+  }
+}  // namespace substring
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "simd_scan.h"
+
+// reusable token storage for a stream of messages
+// fields of one message are copied into a single arena, reset() keeps arena and index capacity,
+// so once buffer has grown to the largest message, decoding does no heap allocations
+//   token_buffer tokens;
+//   for (auto& message : stream) {
+//     tokens.tokenize(message, '\t');
+//     use(tokens[ID], tokens[VALUE]);
+//   }
+class token_buffer {
+public:
+  // drops tokens, keeps capacity
+  void reset() {
+    arena_.clear();
+    spans_.clear();
+  }
+
+  // replaces content with fields of message, returns field count
+  size_t tokenize(std::string_view message, const char delim) {
+    reset();
+    arena_.append(message.data(), message.size());
+    size_t start = 0;
+    simd::scan(arena_, delim, [&](size_t pos) {
+      spans_.push_back({ start, pos - start });
+      start = pos + 1;
+      return true;
+    });
+    spans_.push_back({ start, arena_.size() - start });
+    return spans_.size();
+  }
+
+  // appends one field
+  void push_back(std::string_view field) {
+    spans_.push_back({ arena_.size(), field.size() });
+    arena_.append(field.data(), field.size());
+  }
+
+  size_t size() const { return spans_.size(); }
+  bool empty() const { return spans_.empty(); }
+
+  // valid until next reset/tokenize/push_back
+  std::string_view operator[](size_t index) const {
+    return std::string_view(arena_.data() + spans_[index].offset, spans_[index].length);
+  }
+
+  void reserve(size_t bytes, size_t fields) {
+    arena_.reserve(bytes);
+    spans_.reserve(fields);
+  }
+
+private:
+  // offsets instead of views, arena may move while growing
+  struct span {
+    size_t offset;
+    size_t length;
+  };
+
+  std::string arena_;
+  std::vector<span> spans_;
+};
@@ -1,3 +1,9 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <string>
+
 template <class Container> void tokenizer(const std::string& str, Container* cont,
                                           const std::string& delims, bool skipEmpty) {
   std::size_t current, previous = 0;
@@ -14,3 +20,49 @@ template <class Container> void tokenizer(const std::string& str, Container* con
 
   cont->push_back(str.substr(previous, current - previous));
 }
+
+// delimiter set fixed at compile time
+// single delimiter folds to memchr, several delimiters use 256 entry lookup table built by compiler
+template <char... Delims>
+struct delimiter_set {
+  static_assert(sizeof...(Delims) > 0, "delimiter set is empty");
+
+  static constexpr std::array<bool, 256> make_table() {
+    std::array<bool, 256> table{};
+    ((table[static_cast<unsigned char>(Delims)] = true), ...);
+    return table;
+  }
+
+  static constexpr std::array<bool, 256> table = make_table();
+
+  static constexpr bool contains(char c) { return table[static_cast<unsigned char>(c)]; }
+
+  // first delimiter in [first, last) or last
+  static const char* find(const char* first, const char* last) {
+    if constexpr (sizeof...(Delims) == 1) {
+      auto found = static_cast<const char*>(std::memchr(first, Delims..., last - first));
+      return found ? found : last;
+    } else {
+      while (first != last && !contains(*first)) ++first;
+      return first;
+    }
+  }
+};
+
+// same as tokenizer above, delimiters given as template arguments: tokenizer<'\t'>(str, &cont, false)
+template <char... Delims, class Container>
+void tokenizer(const std::string& str, Container* cont, bool skipEmpty) {
+  const char* previous = str.data();
+  const char* const last = str.data() + str.size();
+
+  const char* current = delimiter_set<Delims...>::find(previous, last);
+  while (current != last) {
+    if (!(skipEmpty == true && current == previous)) {
+      cont->emplace_back(previous, current - previous);
+    }
+    previous = current + 1;
+    current = delimiter_set<Delims...>::find(previous, last);
+  }
+
+  cont->emplace_back(previous, current - previous);
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+// zero-copy tokenizers - tokens are std::string_view slices into caller's buffer
+// caller must keep the buffer alive while tokens are in use
+namespace view {
+
+  // same semantics as tokenizer<Container>, but Container holds std::string_view
+  template <class Container>
+  void tokenizer(std::string_view str, Container* cont, std::string_view delims, bool skipEmpty) {
+    std::size_t current, previous = 0;
+
+    current = str.find_first_of(delims);
+    while (current != std::string_view::npos) {
+      std::string_view token = str.substr(previous, current - previous);
+      if (!(skipEmpty == true && token.empty())) {
+        cont->push_back(token);
+      }
+      previous = current + 1;
+      current = str.find_first_of(delims, previous);
+    }
+
+    cont->push_back(str.substr(previous));
+  }
+
+  // same semantics as SplitParameters - last slot receives the rest of the string
+  inline std::size_t tokenize(std::string_view str, const char delim, std::string_view* parameter_array, const std::size_t parameter_array_size) {
+    if (parameter_array_size == 0) return 0;
+
+    std::size_t pos_start = 0;
+    std::size_t pos_end = str.find(delim);
+    std::size_t found_strings = 0;
+    while ((found_strings + 1 < parameter_array_size) && (pos_end != std::string_view::npos)) {
+      parameter_array[found_strings++] = str.substr(pos_start, pos_end - pos_start);
+      pos_start = pos_end + 1;
+      pos_end = str.find(delim, pos_start);
+    }
+    parameter_array[found_strings++] = str.substr(pos_start);
+    return found_strings;
+  }
+
+  template <std::size_t N>
+  std::size_t tokenize(std::string_view str, const char delim, std::array<std::string_view, N>& out) {
+    return tokenize(str, delim, out.data(), out.size());
+  }
+
+  inline void tokenize(std::string_view str, const char delim, std::vector<std::string_view>& out) {
+    std::size_t pos_start = 0;
+    std::size_t pos_end;
+    while ((pos_end = str.find(delim, pos_start)) != std::string_view::npos) {
+      out.push_back(str.substr(pos_start, pos_end - pos_start));
+      pos_start = pos_end + 1;
+    }
+    out.push_back(str.substr(pos_start));
+  }
+
+  // lazy, allocation-free token range: for (std::string_view tok : view::split(str, '\t'))
+  // cursor lives in the iterator, so any number of threads may split at once (unlike strtok)
+  // skip_empty drops empty tokens the way strtok does
+  class split_range {
+  public:
+    class iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = std::string_view;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const std::string_view*;
+      using reference = std::string_view;
+
+      iterator() = default;
+      iterator(const char* first, const char* last, char delim, bool skip_empty)
+        : pos_(first), last_(last), delim_(delim), skip_empty_(skip_empty) {
+        find_end();
+        if (skip_empty_ && token_end_ == pos_) ++*this;
+      }
+
+      std::string_view operator*() const { return std::string_view(pos_, token_end_ - pos_); }
+
+      iterator& operator++() {
+        do {
+          if (token_end_ == last_) {
+            pos_ = nullptr;
+            return *this;
+          }
+          pos_ = token_end_ + 1;
+          find_end();
+        } while (skip_empty_ && token_end_ == pos_);
+        return *this;
+      }
+
+      iterator operator++(int) {
+        iterator tmp(*this);
+        ++*this;
+        return tmp;
+      }
+
+      bool operator==(const iterator& other) const { return pos_ == other.pos_; }
+      bool operator!=(const iterator& other) const { return pos_ != other.pos_; }
+
+    private:
+      void find_end() {
+        auto found = static_cast<const char*>(std::memchr(pos_, delim_, last_ - pos_));
+        token_end_ = found ? found : last_;
+      }
+
+      const char* pos_ = nullptr;        // current token begin, nullptr past the last token
+      const char* token_end_ = nullptr;  // current token end
+      const char* last_ = nullptr;
+      char delim_ = 0;
+      bool skip_empty_ = false;
+    };
+
+    split_range(std::string_view str, char delim, bool skip_empty)
+      : str_(str), delim_(delim), skip_empty_(skip_empty) {
+    }
+
+    iterator begin() const { return iterator(str_.data(), str_.data() + str_.size(), delim_, skip_empty_); }
+    iterator end() const { return iterator(); }
+
+  private:
+    std::string_view str_;
+    char delim_;
+    bool skip_empty_;
+  };
+
+  inline split_range split(std::string_view str, const char delim, bool skip_empty = false) {
+    return split_range(str, delim, skip_empty);
+  }
+}  // namespace view